@@ -18,9 +18,11 @@
 #include "ssd1306_i2c.h"
 #include "ssd1306.h"
 #include "display.h"
+#include "linha_tempo.h"
+#include "ssd1306_sem_heap.h"
 
 /**
- * @brief Exibe uma mensagem na tela OLED por 2 segundos e em seguida limpa a tela.
+ * @brief Exibe uma mensagem na tela OLED por 2 segundos e agenda a limpeza da tela.
  *
  * @param mensagem  Texto UTF-8 a ser exibido (pode conter múltiplas linhas).
  * @param linha_y   Posição vertical (em pixels) onde a mensagem começará a ser desenhada.
@@ -28,8 +30,7 @@
  * Funcionalidade:
  * - Limpa o conteúdo atual do display.
  * - Desenha o texto informado na posição especificada.
- * - Aguarda por 2000 milissegundos.
- * - Limpa novamente o display.
+ * - Agenda a limpeza do display para daqui a `TEMPO_MENSAGEM` ms (sem bloquear).
  *
  * Utilizada para feedback visual durante eventos como: inicialização, conexão Wi-Fi, reconexão ou erros.
  */
@@ -43,10 +44,6 @@ void exibir_e_esperar(const char *mensagem, int linha_y) {
     // Envia o buffer para ser renderizado fisicamente no display
     render_on_display(buffer_oled, &area);
 
-    // Espera 2 segundos para permitir leitura da mensagem
-    sleep_ms(TEMPO_MENSAGEM);
-
-    // Limpa novamente o conteúdo
-    oled_clear(buffer_oled, &area);
-    render_on_display(buffer_oled, &area);
+    // Agenda a limpeza para daqui a TEMPO_MENSAGEM, sem bloquear o chamador
+    linha_tempo_agendar_limpeza(TEMPO_MENSAGEM);
 }
@@ -23,6 +23,7 @@
 #include "ssd1306.h"
 #include <string.h>  // Para uso da função memset()
 #include "ssd1306_i2c.h"
+#include "ssd1306_sem_heap.h"
 
 /**
  * @brief Inicializa o display OLED via I²C com os parâmetros fornecidos e define a área de renderização.
@@ -72,13 +73,14 @@ void setup_oled(uint8_t *ssd, struct render_area *area, i2c_inst_t *i2c_port, ui
  * @param ssd   Ponteiro para o buffer gráfico.
  * @param area  Estrutura com as coordenadas da área a ser renderizada (normalmente toda a tela).
  *
- * Esta função preenche o buffer com zeros (apagando visualmente a tela) e o envia ao display.
+ * Esta função preenche o buffer com zeros (apagando visualmente a tela) e envia ao display
+ * apenas as colunas que estavam acesas.
  */
 void oled_clear(uint8_t *ssd, struct render_area *area)
 {
-    // Preenche o buffer com zeros (todos os pixels apagados)
-    memset(ssd, 0, ssd1306_buffer_length);
+    // Preenche o buffer com zeros (todos os pixels apagados), marcando o que mudou
+    ssd1306_limpar_buffer(ssd);
 
-    // Envia o buffer atualizado para o display
+    // Envia as janelas alteradas para o display
     render_on_display(ssd, area);
 }
@@ -21,6 +21,7 @@
 #include "ssd1306.h"           // ← necessário para ssd1306_init e calculate_render_area_buffer_length
 #include "oled_utils.h"        // ← necessário para oled_clear
 #include "setup_oled.h"  
+#include "ssd1306_sem_heap.h"
 
 /**
  * @brief Função principal de configuração do sistema.
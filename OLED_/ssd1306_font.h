@@ -13,6 +13,9 @@
  * - Algarismos de 0 a 9
  * - Símbolos pontuais como dois-pontos, vírgula, ponto, hífen, espaço, entre outros.
  *
+ * `font_indice[]` leva cada código Latin-1 ao índice do seu glifo (0: vazio) e é montado
+ * pelo compilador com inicializadores designados, na mesma ordem dos glifos abaixo.
+ *
  * Esta fonte é utilizada por funções gráficas que desenham caracteres e strings no display,
  * como `ssd1306_draw_char()` e `ssd1306_draw_string()`, possibilitando a exibição de textos
  * de forma simples e compacta em sistemas embarcados.
@@ -25,7 +28,8 @@
 #ifndef SSD1306_FONT_H
 #define SSD1306_FONT_H
 
-static uint8_t font[] = {
+// Alinhado a 4 bytes: cada glifo (8 bytes) é lido como duas palavras
+static uint8_t font[] __attribute__((aligned(4))) = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //0: Nothing
     0x78, 0x14, 0x12, 0x11, 0x12, 0x14, 0x78, 0x00, //1: A
     0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x7f, 0x00, //2: B
@@ -122,5 +126,50 @@ static uint8_t font[] = {
 
 };
 
+#define FONTE_N_GLIFOS 93
+
+_Static_assert(sizeof(font) == FONTE_N_GLIFOS * 8, "font[] deve ter 8 bytes por glifo");
+
+// Faixas de códigos consecutivos com glifos consecutivos
+#define GLIFOS_2(c, i)  [(c)] = (i), [(c) + 1] = (i) + 1
+#define GLIFOS_8(c, i)  GLIFOS_2(c, i), GLIFOS_2((c) + 2, (i) + 2), \
+                        GLIFOS_2((c) + 4, (i) + 4), GLIFOS_2((c) + 6, (i) + 6)
+#define GLIFOS_10(c, i) GLIFOS_8(c, i), GLIFOS_2((c) + 8, (i) + 8)
+#define GLIFOS_26(c, i) GLIFOS_8(c, i), GLIFOS_8((c) + 8, (i) + 8), \
+                        GLIFOS_8((c) + 16, (i) + 16), GLIFOS_2((c) + 24, (i) + 24)
+
+// Código Latin-1 → índice do glifo em `font[]`; códigos sem glifo ficam em 0 (vazio)
+static const uint8_t font_indice[256] = {
+    GLIFOS_26('A', 1),
+    GLIFOS_10('0', 27),
+    GLIFOS_26('a', 37),
+    ['.'] = 63, [':'] = 64, ['#'] = 65, ['!'] = 66, ['?'] = 67,
+    [0xC3] = 68,  // Ã
+    [0xC2] = 69,  // Â
+    [0xC1] = 70,  // Á
+    [0xC0] = 71,  // À
+    [0xC9] = 72,  // É
+    [0xCA] = 73,  // Ê
+    [0xCD] = 74,  // Í
+    [0xD3] = 75,  // Ó
+    [0xD4] = 76,  // Ô
+    [0xD5] = 77,  // Õ
+    [0xDA] = 78,  // Ú
+    [0xC7] = 79,  // Ç
+    [0xE7] = 80,  // ç
+    [0xE3] = 81,  // ã
+    [0xE1] = 82,  // á
+    [0xE0] = 83,  // à
+    [0xE2] = 84,  // â
+    [0xE9] = 85,  // é
+    [0xEA] = 86,  // ê
+    [0xED] = 87,  // í
+    [0xF3] = 88,  // ó
+    [0xF4] = 89,  // ô
+    [0xFA] = 90,  // ú
+    [','] = 91,
+    ['-'] = 92,
+};
+
 #endif
 
@@ -12,6 +12,18 @@
  * - Renderização de caracteres e strings (com suporte a acentuação comum).
  * - Desenho de linhas e bitmaps na tela.
  * - Modo buffer (via `ssd1306_t`) para exibições completas.
+ * - Rastreamento de páginas sujas: as funções de desenho marcam, por página, a faixa de
+ *   colunas que realmente mudou, e `render_on_display()` envia apenas essas janelas.
+ *   O rastreamento vale para o framebuffer desenhado (há um só, `buffer_oled`).
+ * - Envio assíncrono: `render_on_display()` copia as janelas sujas para um fluxo de
+ *   palavras de IC_DATA_CMD (o segundo buffer) e o DMA alimenta a FIFO de TX do I²C.
+ *   O desenho continua no framebuffer durante a transferência; um render pedido com
+ *   outra em andamento é agrupado em um único envio posterior (`ssd1306_flush_processar()`).
+ * - Comandos em lote: cada sequência de comandos vai em uma única transação com o byte de
+ *   controle Co=0 (0x00), e o endereçamento da janela é omitido quando repete o anterior.
+ * - Texto: o glifo sai de uma tabela de 256 entradas (`font_indice`), um único
+ *   decodificador UTF-8 atende as duas funções de string e cada glifo é copiado como
+ *   duas palavras de 32 bits quando o destino está alinhado.
  *
  * Ideal para projetos com Raspberry Pi Pico W ou similares que utilizam telas OLED I²C.
  *
@@ -25,41 +37,234 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
 #include "ssd1306_font.h"
 #include "ssd1306_i2c.h"
+#include "ssd1306_sem_heap.h"
+
+// Faixa de colunas suja por página; página limpa quando sujo_ini > sujo_fim
+static uint8_t sujo_ini[ssd1306_n_pages];
+static uint8_t sujo_fim[ssd1306_n_pages];
+static EstatisticasOled est;
+
+#define BYTES_COMANDOS_JANELA 7     // Controle + 6 comandos de endereçamento, uma transação
+#define BYTES_COMANDOS_AVULSOS 12   // Envio anterior: 6 × (controle + comando)
+#define SSD1306_CONTROLE_COMANDOS 0x00   // Co=0, D/C#=0: todos os bytes seguintes são comandos
+#define SSD1306_MAX_LOTE_COMANDOS 32     // Comandos por transação no envio bloqueante
+
+/**
+ * @brief Última janela endereçada no display.
+ *
+ * No modo horizontal, após escrever uma janela inteira o ponteiro do display volta ao
+ * canto inicial dela; a mesma janela pode ser reescrita sem reenviar o endereçamento.
+ * Qualquer outro comando ou escrita de dados avulsa invalida o cache.
+ */
+static struct {
+    bool valida;
+    uint8_t coluna_ini, coluna_fim, pagina_ini, pagina_fim;
+} janela_atual;
+
+// Fluxo para IC_DATA_CMD: byte nos bits 7..0, STOP (fim da transação) no bit 9.
+// Pior caso: uma janela por página, com comandos, controle e a largura inteira.
+#define TAM_FLUXO (ssd1306_n_pages * (BYTES_COMANDOS_JANELA + 1 + ssd1306_width))
+
+static uint16_t fluxo[TAM_FLUXO];
+static uint32_t tam_fluxo;
+static int canal_dma = -1;
+static volatile bool ocupado = false;
+static volatile bool pendente = false;
+static uint8_t *ssd_pendente;
+static struct render_area *area_pendente;
+static void (*ao_concluir)(void) = NULL;
+
+static inline void limpar_pagina(int pagina) {
+    sujo_ini[pagina] = 0xFF;
+    sujo_fim[pagina] = 0;
+}
+
+static inline void marcar_sujo(int pagina, int coluna_ini, int coluna_fim) {
+    if (coluna_ini < sujo_ini[pagina]) {
+        sujo_ini[pagina] = (uint8_t)coluna_ini;
+    }
+    if (coluna_fim > sujo_fim[pagina]) {
+        sujo_fim[pagina] = (uint8_t)coluna_fim;
+    }
+}
+
+static inline bool pagina_inteira(int pagina) {
+    return sujo_ini[pagina] == 0 && sujo_fim[pagina] == ssd1306_width - 1;
+}
+
+// Tela inteira a enviar (conteúdo da RAM do display desconhecido)
+void ssd1306_marcar_tudo(void) {
+    for (int p = 0; p < ssd1306_n_pages; p++) {
+        marcar_sujo(p, 0, ssd1306_width - 1);
+    }
+}
+
+// Zera o framebuffer marcando como sujas apenas as colunas que estavam acesas
+void ssd1306_limpar_buffer(uint8_t *ssd) {
+    for (int p = 0; p < ssd1306_n_pages; p++) {
+        uint8_t *linha = &ssd[p * ssd1306_width];
+        int ini = 0;
+        int fim = ssd1306_width - 1;
+        while (ini <= fim && linha[ini] == 0) {
+            ini++;
+        }
+        while (fim >= ini && linha[fim] == 0) {
+            fim--;
+        }
+        if (ini <= fim) {
+            marcar_sujo(p, ini, fim);
+            memset(&linha[ini], 0, fim - ini + 1);
+        }
+    }
+}
+
+void ssd1306_estatisticas(EstatisticasOled *e) {
+    *e = est;
+}
+
+// ========================
+// ENVIO ASSÍNCRONO (DMA)
+// ========================
+
+// Um NACK do display trava a FIFO de TX até a leitura de IC_CLR_TX_ABRT (que também
+// zera IC_TX_ABRT_SOURCE)
+static void limpar_aborto(void) {
+    i2c_hw_t *hw = i2c_get_hw(i2c1);
+    if ((hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) || hw->tx_abrt_source) {
+        (void)hw->clr_tx_abrt;
+        est.abortados++;
+        janela_atual.valida = false;   // Posição do ponteiro do display desconhecida
+    }
+}
+
+// O fim do DMA só garante que o fluxo entrou na FIFO: até ela esvaziar e o barramento
+// parar, o envio anterior ainda pode abortar depois de limpar_aborto()
+static bool envio_anterior_concluido(void) {
+    uint32_t status = i2c_get_hw(i2c1)->status;
+    return (status & I2C_IC_STATUS_TFE_BITS) && !(status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+// Fim do DMA: todo o fluxo está na FIFO do I²C e o buffer pode ser reescrito
+static void dma_irq_handler(void) {
+    if (canal_dma < 0 || !dma_channel_get_irq1_status(canal_dma)) {
+        return;
+    }
+    dma_channel_acknowledge_irq1(canal_dma);
+    limpar_aborto();
+    ocupado = false;
+    if (ao_concluir) {
+        ao_concluir();
+    }
+}
+
+static void iniciar_dma(void) {
+    if (canal_dma >= 0) {
+        return;
+    }
+    canal_dma = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(canal_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c1, true));
+    dma_channel_configure(canal_dma, &c, &i2c_get_hw(i2c1)->data_cmd, fluxo, 0, false);
+
+    dma_channel_set_irq1_enabled(canal_dma, true);
+    irq_add_shared_handler(DMA_IRQ_1, dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+// Acrescenta uma transação I²C (byte de controle + bytes) ao fluxo
+static void anexar_transacao(uint8_t controle, const uint8_t *bytes, int n) {
+    fluxo[tam_fluxo++] = controle;
+    for (int i = 0; i < n; i++) {
+        fluxo[tam_fluxo++] = bytes[i];
+    }
+    fluxo[tam_fluxo - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    est.transacoes++;
+}
+
+// Callback chamado (na IRQ do DMA) ao fim de cada envio
+void ssd1306_flush_ao_concluir(void (*callback)(void)) {
+    ao_concluir = callback;
+}
+
+bool ssd1306_flush_ocupado(void) {
+    return ocupado || pendente;
+}
+
+// Espera o fim dos envios (inclusive o agrupado) e o barramento ficar livre
+void ssd1306_flush_aguardar(void) {
+    while (ocupado || pendente) {
+        ssd1306_flush_processar();
+        tight_loop_contents();
+    }
+    while (!(i2c_get_hw(i2c1)->status & I2C_IC_STATUS_TFE_BITS)) {
+        tight_loop_contents();
+    }
+    while (i2c_get_hw(i2c1)->status & I2C_IC_STATUS_ACTIVITY_BITS) {
+        tight_loop_contents();
+    }
+}
 
 // Calcular quanto do buffer será destinado à área de renderização
 void calculate_render_area_buffer_length(struct render_area *area) {
     area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
 }
 
+/**
+ * @brief Codificador de comandos: empacota a sequência em transações com o controle Co=0.
+ *
+ * Uma sequência de até `SSD1306_MAX_LOTE_COMANDOS` bytes vira uma única transação
+ * (antes, cada byte ia em uma transação própria com o controle 0x80).
+ */
+static void enviar_comandos(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *comandos, int n) {
+    uint8_t lote[1 + SSD1306_MAX_LOTE_COMANDOS];
+
+    ssd1306_flush_aguardar();   // Não intercala com o fluxo do DMA
+    janela_atual.valida = false;
+
+    lote[0] = SSD1306_CONTROLE_COMANDOS;
+    while (n > 0) {
+        int parte = MIN(n, SSD1306_MAX_LOTE_COMANDOS);
+        memcpy(&lote[1], comandos, parte);
+        i2c_write_blocking(i2c, endereco, lote, parte + 1, false);
+        est.transacoes++;
+        comandos += parte;
+        n -= parte;
+    }
+}
+
 // Processo de escrita do i2c espera um byte de controle, seguido por dados
 void ssd1306_send_command(uint8_t command) {
-    uint8_t buffer[2] = {0x80, command};
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, 2, false);
+    enviar_comandos(i2c1, ssd1306_i2c_address, &command, 1);
 }
 
-// Envia uma lista de comandos ao hardware
+// Envia uma lista de comandos ao hardware (uma transação)
 void ssd1306_send_command_list(uint8_t *ssd, int number) {
-    for (int i = 0; i < number; i++) {
-        ssd1306_send_command(ssd[i]);
-    }
+    enviar_comandos(i2c1, ssd1306_i2c_address, ssd, number);
 }
 
-// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início
+// Envia os dados sem cópia: o byte anterior a `ssd` (o byte reservado do quadro, ou um pixel
+// já enviado, restaurado em seguida) recebe o controle 0x40 durante a transação
 void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
-    uint8_t *temp_buffer = malloc(buffer_length + 1);
-
-    temp_buffer[0] = 0x40;
-    memcpy(temp_buffer + 1, ssd, buffer_length);
-
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
-
-    free(temp_buffer);
+    ssd1306_flush_aguardar();
+
+    uint8_t *inicio = ssd - 1;
+    uint8_t salvo = *inicio;
+    *inicio = ssd1306_data_control;
+    i2c_write_blocking(i2c1, ssd1306_i2c_address, inicio, buffer_length + 1, false);
+    *inicio = salvo;
+    est.transacoes++;
+    janela_atual.valida = false;   // Dados fora de uma janela conhecida
 }
 
 // Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
@@ -86,6 +291,10 @@ void ssd1306_init() {
     };
 
     ssd1306_send_command_list(commands, count_of(commands));
+    iniciar_dma();   // O endereço do display (IC_TAR) já foi programado pelos comandos acima
+
+    // A RAM do display tem conteúdo arbitrário após o reset: o próximo render envia tudo
+    ssd1306_marcar_tudo();
 }
 
 // Cria a lista de comandos para configurar o scrolling
@@ -98,15 +307,102 @@ void ssd1306_scroll(bool set) {
     ssd1306_send_command_list(commands, count_of(commands));
 }
 
-// Atualiza uma parte do display com uma área de renderização
-void render_on_display(uint8_t *ssd, struct render_area *area) {
+// Acrescenta ao fluxo a janela de colunas [coluna_ini, coluna_fim] × páginas [pagina_ini, pagina_fim]
+// (várias páginas só com a largura inteira, quando os dados são contíguos no buffer)
+static void enviar_janela(uint8_t *ssd, int coluna_ini, int coluna_fim, int pagina_ini, int pagina_fim) {
     uint8_t commands[] = {
-        ssd1306_set_column_address, area->start_column, area->end_column,
-        ssd1306_set_page_address, area->start_page, area->end_page
+        ssd1306_set_column_address, coluna_ini, coluna_fim,
+        ssd1306_set_page_address, pagina_ini, pagina_fim
     };
+    int tamanho = (coluna_fim - coluna_ini + 1) * (pagina_fim - pagina_ini + 1);
+
+    bool mesma_janela = janela_atual.valida &&
+                        janela_atual.coluna_ini == coluna_ini && janela_atual.coluna_fim == coluna_fim &&
+                        janela_atual.pagina_ini == pagina_ini && janela_atual.pagina_fim == pagina_fim;
+    if (mesma_janela) {
+        est.enderecamentos_evitados++;
+    } else {
+        anexar_transacao(SSD1306_CONTROLE_COMANDOS, commands, count_of(commands));
+        est.bytes += BYTES_COMANDOS_JANELA;
+        janela_atual.valida = true;
+        janela_atual.coluna_ini = coluna_ini;
+        janela_atual.coluna_fim = coluna_fim;
+        janela_atual.pagina_ini = pagina_ini;
+        janela_atual.pagina_fim = pagina_fim;
+    }
+    anexar_transacao(ssd1306_data_control, &ssd[pagina_ini * ssd1306_width + coluna_ini], tamanho);
 
-    ssd1306_send_command_list(commands, count_of(commands));
-    ssd1306_send_buffer(ssd, area->buffer_length);
+    est.janelas++;
+    est.bytes += tamanho + 1;
+}
+
+// Copia as janelas sujas para o fluxo e dispara o DMA
+static void iniciar_flush(uint8_t *ssd, struct render_area *area) {
+    limpar_aborto();   // Antes de montar: um aborto invalida o cache da janela
+    if (!envio_anterior_concluido()) {
+        janela_atual.valida = false;   // Sem confirmação: reenvia o endereçamento
+    }
+    tam_fluxo = 0;
+    for (int p = area->start_page; p <= area->end_page; p++) {
+        int ini = MAX(sujo_ini[p], area->start_column);
+        int fim = MIN(sujo_fim[p], area->end_column);
+        if (ini > fim) {
+            continue;
+        }
+
+        int ultima = p;
+        if (pagina_inteira(p) && ini == 0 && fim == ssd1306_width - 1) {
+            while (ultima < area->end_page && pagina_inteira(ultima + 1)) {
+                ultima++;
+            }
+        }
+        enviar_janela(ssd, ini, fim, p, ultima);
+
+        for (int q = p; q <= ultima; q++) {
+            // Parte fora da área continua suja para um próximo render
+            if (sujo_ini[q] >= area->start_column && sujo_fim[q] <= area->end_column) {
+                limpar_pagina(q);
+            }
+        }
+        p = ultima;
+    }
+
+    if (tam_fluxo > 0) {
+        ocupado = true;
+        dma_channel_transfer_from_buffer_now(canal_dma, fluxo, tam_fluxo);
+    }
+}
+
+/**
+ * @brief Atualiza o display, dentro da área de renderização, apenas onde o buffer mudou.
+ *
+ * Cada página suja vira uma janela com a sua faixa de colunas; páginas consecutivas
+ * sujas na largura inteira são agrupadas em uma única janela. Não bloqueia: com um
+ * envio em andamento, o pedido fica pendente e as páginas sujas se acumulam até ele.
+ */
+void render_on_display(uint8_t *ssd, struct render_area *area) {
+    est.quadros++;
+    est.bytes_quadro_inteiro += BYTES_COMANDOS_AVULSOS + area->buffer_length + 1;
+
+    if (ocupado) {
+        ssd_pendente = ssd;
+        area_pendente = area;
+        if (pendente) {
+            est.agrupados++;
+        }
+        pendente = true;
+        return;
+    }
+    pendente = false;
+    iniciar_flush(ssd, area);
+}
+
+// Dispara o envio agrupado, se houver (laço principal, após o aviso de conclusão)
+void ssd1306_flush_processar(void) {
+    if (pendente && !ocupado) {
+        pendente = false;
+        iniciar_flush(ssd_pendente, area_pendente);
+    }
 }
 
 // Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
@@ -125,7 +421,10 @@ void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
         byte &= ~(1 << (y % 8));
     }
 
-    ssd[byte_idx] = byte;
+    if (byte != ssd[byte_idx]) {
+        ssd[byte_idx] = byte;
+        marcar_sujo(y / 8, x, x);
+    }
 }
 
 // Algoritmo de Bresenham básico
@@ -156,62 +455,60 @@ void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool se
     }
 }
 
-// ------------------------------------------------------------
-// Função auxiliar para obter índice da fonte no array `font`
-// ------------------------------------------------------------
-static inline int ssd1306_get_font(uint8_t character) {
-    if (character >= 'A' && character <= 'Z') return character - 'A' + 1;
-    if (character >= '0' && character <= '9') return character - '0' + 27;
-    if (character >= 'a' && character <= 'z') return character - 'a' + 37;
-    if (character == '.') return 63;
-    if (character == ':') return 64;
-    if (character == 0x23) return 65;  // #
-    if (character == 0x21) return 66;  // !
-    if (character == 0x3F) return 67;  // ?
-    if (character == 0xC3) return 68;  // Ã
-    if (character == 0xC2) return 69;  // Â
-    if (character == 0xC1) return 70;  // Á
-    if (character == 0xC0) return 71;  // À
-    if (character == 0xC9) return 72;  // É
-    if (character == 0xCA) return 73;  // Ê
-    if (character == 0xCD) return 74;  // Í
-    if (character == 0xD3) return 75;  // Ó
-    if (character == 0xD4) return 76;  // Ô
-    if (character == 0xD5) return 77;  // Õ
-    if (character == 0xDA) return 78;  // Ú
-    if (character == 0xC7) return 79;  // Ç
-    if (character == 0xE7) return 80;  // ç
-    if (character == 0xE3) return 81;  // ã
-    if (character == 0xE1) return 82;  // á
-    if (character == 0xE0) return 83;  // à
-    if (character == 0xE2) return 84;  // â
-    if (character == 0xE9) return 85;  // é
-    if (character == 0xEA) return 86;  // ê
-    if (character == 0xED) return 87;  // í
-    if (character == 0xF3) return 88;  // ó
-    if (character == 0xF4) return 89;  // ô
-    if (character == 0xFA) return 90;  // ú
-    if (character == 0x2C) return 91;  // ,
-    if (character == '-')  return 92;  // -
-
-    return 0; // caractere vazio/inválido
-}
-
-// Desenha um único caractere no display
+// Palavra de 32 bits que pode apelidar o framebuffer e a fonte (declarados como bytes)
+typedef uint32_t __attribute__((may_alias)) palavra_t;
+
+/**
+ * @brief Copia as 8 colunas de um glifo para a página `pagina` a partir da coluna `x`.
+ *
+ * Com destino alinhado a 4 bytes (framebuffer alinhado e `x` múltiplo de 4, o caso de
+ * todo texto do firmware), compara e grava duas palavras; as colunas sujas saem dos
+ * bytes que diferem. Sem alinhamento, o Cortex-M0+ falharia no acesso: cópia por byte.
+ */
+static void copiar_glifo(uint8_t *ssd, int pagina, int x, uint8_t codigo) {
+    const uint8_t *glifo = &font[font_indice[codigo] * 8];
+    uint8_t *destino = &ssd[pagina * ssd1306_width + x];
+    int ini, fim;
+
+    if (((uintptr_t)destino & 3) == 0) {
+        palavra_t *d = (palavra_t *)destino;
+        const palavra_t *g = (const palavra_t *)glifo;
+        uint32_t dif0 = d[0] ^ g[0];
+        uint32_t dif1 = d[1] ^ g[1];
+        if ((dif0 | dif1) == 0) {
+            return;
+        }
+        d[0] = g[0];
+        d[1] = g[1];
+        // Little-endian: a coluna de menor x está no byte menos significativo
+        ini = dif0 ? __builtin_ctz(dif0) / 8 : 4 + __builtin_ctz(dif1) / 8;
+        fim = dif1 ? 7 - __builtin_clz(dif1) / 8 : 3 - __builtin_clz(dif0) / 8;
+    } else {
+        ini = -1;
+        fim = -1;
+        for (int i = 0; i < 8; i++) {
+            if (destino[i] != glifo[i]) {
+                destino[i] = glifo[i];
+                if (ini < 0) {
+                    ini = i;
+                }
+                fim = i;
+            }
+        }
+        if (ini < 0) {
+            return;
+        }
+    }
+    marcar_sujo(pagina, x + ini, x + fim);
+}
+
+// Desenha um único caractere (código Latin-1) no display
 void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character) {
     if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
         return;
     }
 
-    y = y / 8;
-
-    //character = toupper(character);
-    int idx = ssd1306_get_font(character);
-    int fb_idx = y * 128 + x;
-
-    for (int i = 0; i < 8; i++) {
-        ssd[fb_idx++] = font[idx * 8 + i];
-    }
+    copiar_glifo(ssd, y / 8, x, character);
 }
 
 // Desenha uma string, chamando a função de desenhar caractere várias vezes
@@ -220,48 +517,44 @@ void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
         return;
     }
 
-    while (*string) {
-        ssd1306_draw_char(ssd, x, y, *string++);
+    while (*string && x <= ssd1306_width - 8) {
+        copiar_glifo(ssd, y / 8, x, (uint8_t)*string++);
         x += 8;
     }
 }
 
 // Comando de configuração com base na estrutura ssd1306_t
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
-  ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-	ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false );
+    enviar_comandos(ssd->i2c_port, ssd->address, &command, 1);
 }
 
-// Função de configuração do display para o caso do bitmap
+// Função de configuração do display para o caso do bitmap (uma transação)
 void ssd1306_config(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_display | 0x00);
-    ssd1306_command(ssd, ssd1306_set_memory_mode);
-    ssd1306_command(ssd, 0x01);
-    ssd1306_command(ssd, ssd1306_set_display_start_line | 0x00);
-    ssd1306_command(ssd, ssd1306_set_segment_remap | 0x01);
-    ssd1306_command(ssd, ssd1306_set_mux_ratio);
-    ssd1306_command(ssd, ssd1306_height - 1);
-    ssd1306_command(ssd, ssd1306_set_common_output_direction | 0x08);
-    ssd1306_command(ssd, ssd1306_set_display_offset);
-    ssd1306_command(ssd, 0x00);
-    ssd1306_command(ssd, ssd1306_set_common_pin_configuration);
-    ssd1306_command(ssd, 0x12);
-    ssd1306_command(ssd, ssd1306_set_display_clock_divide_ratio);
-    ssd1306_command(ssd, 0x80);
-    ssd1306_command(ssd, ssd1306_set_precharge);
-    ssd1306_command(ssd, 0xF1);
-    ssd1306_command(ssd, ssd1306_set_vcomh_deselect_level);
-    ssd1306_command(ssd, 0x30);
-    ssd1306_command(ssd, ssd1306_set_contrast);
-    ssd1306_command(ssd, 0xFF);
-    ssd1306_command(ssd, ssd1306_set_entire_on);
-    ssd1306_command(ssd, ssd1306_set_normal_display);
-    ssd1306_command(ssd, ssd1306_set_charge_pump);
-    ssd1306_command(ssd, 0x14);
-    ssd1306_command(ssd, ssd1306_set_display | 0x01);
+    uint8_t commands[] = {
+        ssd1306_set_display | 0x00,
+        ssd1306_set_memory_mode, 0x01,
+        ssd1306_set_display_start_line | 0x00,
+        ssd1306_set_segment_remap | 0x01,
+        ssd1306_set_mux_ratio, ssd1306_height - 1,
+        ssd1306_set_common_output_direction | 0x08,
+        ssd1306_set_display_offset, 0x00,
+        ssd1306_set_common_pin_configuration, 0x12,
+        ssd1306_set_display_clock_divide_ratio, 0x80,
+        ssd1306_set_precharge, 0xF1,
+        ssd1306_set_vcomh_deselect_level, 0x30,
+        ssd1306_set_contrast, 0xFF,
+        ssd1306_set_entire_on,
+        ssd1306_set_normal_display,
+        ssd1306_set_charge_pump, 0x14,
+        ssd1306_set_display | 0x01,
+    };
+
+    enviar_comandos(ssd->i2c_port, ssd->address, commands, count_of(commands));
 }
 
+// Quadro do modo bitmap (um display por vez), com o byte de controle reservado
+static uint8_t quadro_bm[ssd1306_frame_length];
+
 // Inicializa o display para o caso de exibição de bitmap
 void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
     ssd->width = width;
@@ -270,30 +563,55 @@ void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool externa
     ssd->address = address;
     ssd->i2c_port = i2c;
     ssd->bufsize = ssd->pages * ssd->width + 1;
-    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-    ssd->ram_buffer[0] = 0x40;
-    ssd->port_buffer[0] = 0x80;
+    assert(ssd->bufsize <= sizeof(quadro_bm));
+    ssd->ram_buffer = quadro_bm;
+    memset(ssd->ram_buffer, 0, ssd->bufsize);
+    ssd->ram_buffer[0] = ssd1306_data_control;
 }
 
 // Envia os dados ao display
 void ssd1306_send_data(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_column_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->width - 1);
-    ssd1306_command(ssd, ssd1306_set_page_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->pages - 1);
+    uint8_t commands[] = {
+        ssd1306_set_column_address, 0, ssd->width - 1,
+        ssd1306_set_page_address, 0, ssd->pages - 1,
+    };
+
+    enviar_comandos(ssd->i2c_port, ssd->address, commands, count_of(commands));
     i2c_write_blocking(
     ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false );
+    est.transacoes++;
 }
 
 // Desenha o bitmap (a ser fornecido em display_oled.c) no display
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
-    for (int i = 0; i < ssd->bufsize - 1; i++) {
-        ssd->ram_buffer[i + 1] = bitmap[i];
+    memcpy(&ssd->ram_buffer[1], bitmap, ssd->bufsize - 1);
+    ssd1306_send_data(ssd);
+}
+
+/**
+ * @brief Decodifica um caractere UTF-8 em `*codigo` (Latin-1) e devolve o início do próximo.
+ *
+ * Sequências de 2 bytes viram o código U+0080..U+07FF truncado a 8 bits (os acentos da
+ * fonte ficam todos em U+00C0..U+00FF). Sequências mais longas, ou malformadas, viram
+ * um único caractere vazio; o decodificador nunca passa do terminador da string.
+ */
+static const char *decodificar_utf8(const char *s, uint8_t *codigo) {
+    uint8_t c = (uint8_t)*s++;
+
+    if ((c & 0x80) == 0) {
+        *codigo = c;   // ASCII puro (0x00–0x7F)
+        return s;
+    }
+    if ((c & 0xE0) == 0xC0 && ((uint8_t)*s & 0xC0) == 0x80) {
+        *codigo = (uint8_t)((c << 6) | ((uint8_t)*s & 0x3F));
+        return s + 1;
+    }
 
-        ssd1306_send_data(ssd);
+    *codigo = 0;
+    while (((uint8_t)*s & 0xC0) == 0x80) {
+        s++;       // Descarta os bytes de continuação
     }
+    return s;
 }
 
 // Função que converte string UTF-8 para Latin-1 e imprime no OLED
@@ -302,29 +620,11 @@ void ssd1306_draw_utf8_string(uint8_t *ssd, int16_t x, int16_t y, const char *ut
         return;
     }
 
-    while (*utf8_string) {
-        uint8_t c = (uint8_t)*utf8_string;
-
-        if ((c & 0x80) == 0) {
-            // ASCII puro (0x00–0x7F)
-            ssd1306_draw_char(ssd, x, y, c);
-            utf8_string++;
-        }
-        else if ((c & 0xE0) == 0xC0) {
-            // UTF-8 de 2 bytes (ex: ç, é, ã, ó)
-            uint8_t first = (uint8_t)*utf8_string++;
-            uint8_t second = (uint8_t)*utf8_string++;
-
-            // Reconstrói o código Latin-1 correspondente
-            uint8_t latin1 = ((first & 0x1F) << 6) | (second & 0x3F);
-
-            ssd1306_draw_char(ssd, x, y, latin1);
-        }
-        else {
-            // UTF-8 de 3+ bytes não suportado: pula
-            utf8_string++;
-        }
-
+    // Caracteres além da borda direita não seriam desenhados: para na borda
+    while (*utf8_string && x <= ssd1306_width - 8) {
+        uint8_t codigo;
+        utf8_string = decodificar_utf8(utf8_string, &codigo);
+        copiar_glifo(ssd, y / 8, x, codigo);
         x += 8; // Avança 8 pixels por caractere
     }
 }
@@ -336,23 +636,10 @@ void ssd1306_draw_utf8_multiline(uint8_t *ssd, int16_t x, int16_t y, const char
     const int char_height = 8;
 
     while (*utf8_string && y <= (max_height - char_height)) {
-        uint8_t c = (uint8_t)*utf8_string;
-
-        if ((c & 0x80) == 0) {
-            // ASCII puro
-            ssd1306_draw_char(ssd, x, y, c);
-            utf8_string++;
-        }
-        else if ((c & 0xE0) == 0xC0) {
-            // UTF-8 de 2 bytes → Latin-1
-            uint8_t first = (uint8_t)*utf8_string++;
-            uint8_t second = (uint8_t)*utf8_string++;
-            uint8_t latin1 = ((first & 0x1F) << 6) | (second & 0x3F);
-            ssd1306_draw_char(ssd, x, y, latin1);
-        }
-        else {
-            // Ignora UTF-8 > 2 bytes
-            utf8_string++;
+        uint8_t codigo;
+        utf8_string = decodificar_utf8(utf8_string, &codigo);
+        if (x <= max_width - char_width) {
+            copiar_glifo(ssd, y / 8, x, codigo);
         }
 
         x += char_width;
@@ -13,6 +13,10 @@
  * - Estrutura `render_area` para delimitar áreas específicas da tela a serem renderizadas.
  * - Estrutura `ssd1306_t` que encapsula propriedades da tela e ponteiros para buffers.
  * - Funções para desenhar texto UTF-8: `ssd1306_draw_utf8_string()` e `ssd1306_draw_utf8_multiline()`.
+ * - Rastreamento de páginas sujas (`ssd1306_marcar_tudo()`, `ssd1306_limpar_buffer()`) e
+ *   contagem dos bytes enviados ao display (`EstatisticasOled`).
+ * - Envio assíncrono por DMA (`render_on_display()` não bloqueia), com aviso de conclusão
+ *   e agrupamento dos pedidos feitos durante um envio (`ssd1306_flush_*`).
  *
  * Este módulo é base para projetos gráficos embarcados com microcontroladores, como o Raspberry Pi Pico,
  * oferecendo controle direto e de baixo nível sobre o display OLED via comandos SSD1306 padronizados.
@@ -70,6 +74,11 @@ void ssd1306_draw_utf8_multiline(uint8_t *ssd, int16_t x, int16_t y, const char
 #define ssd1306_n_pages (ssd1306_height / ssd1306_page_height)
 #define ssd1306_buffer_length (ssd1306_n_pages * ssd1306_width)
 
+// Quadro em memória: o byte de controle de dados (0x40) fica reservado logo antes dos
+// pixels, para que o buffer seja enviado sem cópia nem alocação
+#define ssd1306_data_control _u(0x40)
+#define ssd1306_frame_length (ssd1306_buffer_length + 1)
+
 #define ssd1306_write_mode _u(0xFE)
 #define ssd1306_read_mode _u(0xFF)
 
@@ -82,13 +91,34 @@ struct render_area {
     int buffer_length;
 };
 
+// Bytes enviados pelo I²C (controle + dados, sem o byte de endereço)
+typedef struct {
+    uint32_t quadros;               // Chamadas a render_on_display()
+    uint32_t janelas;               // Janelas de colunas/páginas efetivamente enviadas
+    uint32_t bytes;
+    uint32_t bytes_quadro_inteiro;  // O que o envio da área inteira teria custado
+    uint32_t agrupados;             // Renders absorvidos por um envio já pendente
+    uint32_t abortados;             // Transferências com NACK do display
+    uint32_t transacoes;            // Transações I2C (comandos e dados), bloqueantes ou via DMA
+    uint32_t enderecamentos_evitados;  // Janelas iguais à anterior, enviadas sem endereçamento
+} EstatisticasOled;
+
+void ssd1306_marcar_tudo(void);
+void ssd1306_limpar_buffer(uint8_t *ssd);
+void ssd1306_estatisticas(EstatisticasOled *e);
+
+// Envio assíncrono: o callback roda na IRQ do DMA; processar() dispara o envio agrupado
+void ssd1306_flush_ao_concluir(void (*callback)(void));
+void ssd1306_flush_processar(void);
+bool ssd1306_flush_ocupado(void);
+void ssd1306_flush_aguardar(void);
+
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t * i2c_port;
   bool external_vcc;
   uint8_t *ram_buffer;
   size_t bufsize;
-  uint8_t port_buffer[2];
 } ssd1306_t;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,12 @@
+/**
+ * @file ssd1306_sem_heap.h
+ * @brief Modo de alocação estática do caminho do display (`SSD1306_ALOCACAO_ESTATICA`).
+ *
+ * Incluído por último nos arquivos de OLED_/: com o modo ativo, qualquer uso de
+ * malloc/calloc/realloc/free nesses arquivos vira erro de compilação.
+ */
+
+#ifdef SSD1306_ALOCACAO_ESTATICA
+#include <stdlib.h>
+#pragma GCC poison malloc calloc realloc free
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file assinaturas_mqtt.c
+ * @brief Implementação da trie de filtros de tópico e do despacho de mensagens recebidas.
+ *
+ * Cada nó representa um nível do filtro. Os filhos formam uma lista encadeada
+ * (`filho`/`irmao`); o curinga `+` é um filho com segmento "+", e o curinga `#`
+ * é guardado como máscara no nó pai, já que sempre encerra o filtro.
+ */
+
+#include "assinaturas_mqtt.h"
+#include "lwip/apps/mqtt.h"
+#include <string.h>
+
+_Static_assert(MQTT_MAX_ASSINATURAS <= 32, "máscara de tratadores usa 32 bits");
+_Static_assert(MQTT_MAX_NOS_TOPICO <= INT8_MAX, "índices de nós usam int8_t");
+
+#define SEM_NO (-1)
+
+typedef struct {
+    uint16_t segmento;          // Início do texto do nível em pool_segmentos
+    uint8_t tam_segmento;
+    int8_t filho;
+    int8_t irmao;
+    uint32_t terminais;         // Tratadores cujo filtro termina neste nível
+    uint32_t cerquilha;         // Tratadores com filtro "<este nível>/#"
+} NoTopico;
+
+typedef struct {
+    TratadorMQTT tratador;
+    void *contexto;
+} DestinoMQTT;
+
+static NoTopico nos[MQTT_MAX_NOS_TOPICO];
+static int n_nos = 0;
+static char pool_segmentos[MQTT_TAM_POOL_TOPICOS];
+static uint16_t pool_usado = 0;
+
+static DestinoMQTT destinos[MQTT_MAX_ASSINATURAS];
+static int n_destinos = 0;
+
+// Mensagem em recepção
+static char topico_atual[MQTT_TAM_TOPICO];
+static uint32_t destinos_atuais = 0;
+static uint32_t total_atual = 0;
+static uint32_t deslocamento_atual = 0;
+static uint32_t sem_destino = 0;
+
+static int novo_no(const char *segmento, uint8_t tam) {
+    if (n_nos >= MQTT_MAX_NOS_TOPICO || pool_usado + tam > MQTT_TAM_POOL_TOPICOS) {
+        return SEM_NO;
+    }
+    NoTopico *no = &nos[n_nos];
+    memset(no, 0, sizeof(*no));
+    no->segmento = pool_usado;
+    no->tam_segmento = tam;
+    no->filho = SEM_NO;
+    no->irmao = SEM_NO;
+    memcpy(&pool_segmentos[pool_usado], segmento, tam);
+    pool_usado += tam;
+    return n_nos++;
+}
+
+void assinaturas_inicializar(void) {
+    n_nos = 0;
+    pool_usado = 0;
+    n_destinos = 0;
+    sem_destino = 0;
+    novo_no("", 0);  // Raiz
+}
+
+static bool segmento_igual(const NoTopico *no, const char *segmento, size_t tam) {
+    return no->tam_segmento == tam && memcmp(&pool_segmentos[no->segmento], segmento, tam) == 0;
+}
+
+// Procura (ou cria) o filho de `pai` com o segmento dado
+static int obter_filho(int pai, const char *segmento, size_t tam) {
+    for (int f = nos[pai].filho; f != SEM_NO; f = nos[f].irmao) {
+        if (segmento_igual(&nos[f], segmento, tam)) {
+            return f;
+        }
+    }
+    if (tam > UINT8_MAX) {
+        return SEM_NO;
+    }
+    int f = novo_no(segmento, (uint8_t)tam);
+    if (f != SEM_NO) {
+        nos[f].irmao = nos[pai].filho;
+        nos[pai].filho = (int8_t)f;
+    }
+    return f;
+}
+
+/**
+ * @brief Valida o filtro e o insere na trie.
+ *
+ * Regras do MQTT: `+` e `#` ocupam um nível inteiro e `#` só pode ser o último.
+ */
+bool assinaturas_registrar(const char *filtro, TratadorMQTT tratador, void *contexto) {
+    if (n_destinos >= MQTT_MAX_ASSINATURAS || !filtro[0]) {
+        return false;
+    }
+
+    int no = 0;
+    bool cerquilha = false;
+    const char *nivel = filtro;
+    while (true) {
+        const char *fim = strchr(nivel, '/');
+        size_t tam = fim ? (size_t)(fim - nivel) : strlen(nivel);
+
+        if (tam == 1 && nivel[0] == '#') {
+            if (fim) {
+                return false;
+            }
+            cerquilha = true;
+            break;
+        }
+        if (memchr(nivel, '#', tam) || (tam > 1 && memchr(nivel, '+', tam))) {
+            return false;
+        }
+
+        no = obter_filho(no, nivel, tam);
+        if (no == SEM_NO) {
+            return false;
+        }
+        if (!fim) {
+            break;
+        }
+        nivel = fim + 1;
+    }
+
+    uint32_t bit = 1u << n_destinos;
+    if (cerquilha) {
+        nos[no].cerquilha |= bit;
+    } else {
+        nos[no].terminais |= bit;
+    }
+    destinos[n_destinos].tratador = tratador;
+    destinos[n_destinos].contexto = contexto;
+    n_destinos++;
+    return true;
+}
+
+/**
+ * @brief Casa os níveis restantes do tópico a partir de `no`.
+ *
+ * @param nivel início do próximo nível, ou NULL se o tópico acabou
+ */
+static uint32_t casar(int no, const char *nivel) {
+    // "a/#" casa também com "a" (zero níveis restantes)
+    uint32_t resultado = nos[no].cerquilha;
+    if (!nivel) {
+        return resultado | nos[no].terminais;
+    }
+
+    const char *fim = strchr(nivel, '/');
+    size_t tam = fim ? (size_t)(fim - nivel) : strlen(nivel);
+    const char *proximo = fim ? fim + 1 : NULL;
+
+    for (int f = nos[no].filho; f != SEM_NO; f = nos[f].irmao) {
+        if (segmento_igual(&nos[f], nivel, tam) ||
+            (nos[f].tam_segmento == 1 && pool_segmentos[nos[f].segmento] == '+')) {
+            resultado |= casar(f, proximo);
+        }
+    }
+    return resultado;
+}
+
+static uint32_t casar_topico(const char *topico) {
+    if (topico[0] == '$') {
+        // Tópicos de sistema ($SYS/...) não casam com curingas no primeiro nível
+        uint32_t resultado = 0;
+        const char *fim = strchr(topico, '/');
+        size_t tam = fim ? (size_t)(fim - topico) : strlen(topico);
+        for (int f = nos[0].filho; f != SEM_NO; f = nos[f].irmao) {
+            if (segmento_igual(&nos[f], topico, tam)) {
+                resultado |= casar(f, fim ? fim + 1 : NULL);
+            }
+        }
+        return resultado;
+    }
+    return casar(0, topico);
+}
+
+// Início de uma mensagem recebida: casa o tópico (completo) uma única vez
+void assinaturas_publish_cb(void *arg, const char *topico, uint32_t tamanho_total) {
+    strncpy(topico_atual, topico, sizeof(topico_atual) - 1);
+    topico_atual[sizeof(topico_atual) - 1] = '\0';
+    destinos_atuais = casar_topico(topico);
+    total_atual = tamanho_total;
+    deslocamento_atual = 0;
+    if (!destinos_atuais) {
+        sem_destino++;
+    }
+}
+
+// Fragmento do payload: repassado sem cópia a cada tratador que casou
+void assinaturas_dados_cb(void *arg, const uint8_t *dados, uint16_t tamanho, uint8_t flags) {
+    FragmentoMQTT fragmento = {
+        .topico = topico_atual,
+        .dados = dados,
+        .tamanho = tamanho,
+        .deslocamento = deslocamento_atual,
+        .total = total_atual,
+        .ultimo = (flags & MQTT_DATA_FLAG_LAST) != 0,
+    };
+
+    for (uint32_t m = destinos_atuais; m; m &= m - 1) {
+        int i = __builtin_ctz(m);
+        destinos[i].tratador(&fragmento, destinos[i].contexto);
+    }
+    deslocamento_atual += tamanho;
+}
+
+uint32_t assinaturas_sem_destino(void) {
+    return sem_destino;
+}
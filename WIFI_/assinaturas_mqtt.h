@@ -0,0 +1,45 @@
+/**
+ * @file assinaturas_mqtt.h
+ * @brief Tabela de assinaturas MQTT com curingas `+`/`#` compilada em uma trie.
+ *
+ * Cada filtro é quebrado em níveis no registro e inserido em uma trie de nós
+ * estáticos (sem heap). Uma mensagem recebida é casada percorrendo a trie nível a
+ * nível, em tempo proporcional ao tamanho do tópico, e entregue aos tratadores
+ * de todos os filtros que casaram.
+ *
+ * Os tratadores recebem o payload em fragmentos, apontando diretamente para o
+ * buffer de recepção da lwIP (sem cópia). São chamados no contexto da lwIP
+ * (núcleo 1): devem ser curtos e não devem acessar o OLED.
+ */
+
+#ifndef ASSINATURAS_MQTT_H
+#define ASSINATURAS_MQTT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "configura_geral.h"
+
+typedef struct {
+    const char *topico;      // Tópico da mensagem atual
+    const uint8_t *dados;    // Fragmento no buffer de recepção da lwIP
+    uint16_t tamanho;        // Bytes neste fragmento
+    uint32_t deslocamento;   // Posição do fragmento no payload
+    uint32_t total;          // Tamanho total do payload
+    bool ultimo;             // Último fragmento da mensagem
+} FragmentoMQTT;
+
+typedef void (*TratadorMQTT)(const FragmentoMQTT *fragmento, void *contexto);
+
+void assinaturas_inicializar(void);
+
+// Compila o filtro na trie. Retorna false se inválido ou sem espaço.
+bool assinaturas_registrar(const char *filtro, TratadorMQTT tratador, void *contexto);
+
+// Ligação com mqtt_set_inbound_publish_cb()
+void assinaturas_publish_cb(void *arg, const char *topico, uint32_t tamanho_total);
+void assinaturas_dados_cb(void *arg, const uint8_t *dados, uint16_t tamanho, uint8_t flags);
+
+// Mensagens recebidas sem nenhum filtro correspondente
+uint32_t assinaturas_sem_destino(void);
+
+#endif
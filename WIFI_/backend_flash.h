@@ -0,0 +1,40 @@
+/**
+ * @file backend_flash.h
+ * @brief Interface de armazenamento usada pelo registro persistente (`registro_flash.h`).
+ *
+ * Os deslocamentos são relativos ao início da região reservada. A implementação
+ * para o Pico grava na flash interna (`backend_flash_pico()`); como o registro só
+ * conhece esta interface, ele é exercitado no host sobre um arquivo comum
+ * (`backend_flash_arquivo.c`, usado por `testes_host/teste_registro_flash.c`).
+ */
+
+#ifndef BACKEND_FLASH_H
+#define BACKEND_FLASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t tam_setor;     // Unidade de apagamento
+    uint32_t tam_pagina;    // Unidade de programação
+    uint32_t n_setores;
+
+    void (*ler)(void *ctx, uint32_t deslocamento, void *destino, uint32_t tamanho);
+
+    // Apaga o setor e grava `tam_setor` bytes de uma vez
+    bool (*gravar_setor)(void *ctx, uint32_t setor, const uint8_t *dados);
+
+    // Programa uma página sem apagar (só leva bits de 1 para 0)
+    bool (*programar_pagina)(void *ctx, uint32_t deslocamento, const uint8_t *pagina);
+
+    void *ctx;
+} BackendFlash;
+
+// Backend sobre os últimos `REGISTRO_FLASH_SETORES` setores da flash do Pico
+const BackendFlash *backend_flash_pico(void);
+
+// Backend sobre um arquivo com semântica de flash NOR (testes no host)
+bool backend_flash_arquivo_abrir(BackendFlash *backend, const char *caminho, uint32_t n_setores);
+void backend_flash_arquivo_fechar(BackendFlash *backend);
+
+#endif
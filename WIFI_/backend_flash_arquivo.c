@@ -0,0 +1,86 @@
+/**
+ * @file backend_flash_arquivo.c
+ * @brief Backend de armazenamento sobre um arquivo, para testar o registro no host.
+ *
+ * Reproduz a semântica da flash NOR: apagar leva o setor para 0xFF e programar só
+ * leva bits de 1 para 0 (o novo conteúdo é o AND com o anterior). O arquivo sobrevive
+ * ao fechamento, o que permite simular um reboot reabrindo-o.
+ */
+
+#include "backend_flash.h"
+#include "configura_geral.h"
+#include <string.h>
+
+static bool posicionar(FILE *f, uint32_t deslocamento) {
+    return fseek(f, (long)deslocamento, SEEK_SET) == 0;
+}
+
+static void ler(void *ctx, uint32_t deslocamento, void *destino, uint32_t tamanho) {
+    FILE *f = (FILE *)ctx;
+    if (!posicionar(f, deslocamento) || fread(destino, 1, tamanho, f) != tamanho) {
+        memset(destino, 0xFF, tamanho);
+    }
+}
+
+static bool gravar_setor(void *ctx, uint32_t setor, const uint8_t *dados) {
+    FILE *f = (FILE *)ctx;
+    // Apagar e programar a partir de 0xFF resulta nos próprios dados
+    return posicionar(f, setor * REGISTRO_FLASH_TAM_SETOR) &&
+           fwrite(dados, 1, REGISTRO_FLASH_TAM_SETOR, f) == REGISTRO_FLASH_TAM_SETOR &&
+           fflush(f) == 0;
+}
+
+static bool programar_pagina(void *ctx, uint32_t deslocamento, const uint8_t *pagina) {
+    FILE *f = (FILE *)ctx;
+    uint8_t atual[REGISTRO_FLASH_TAM_PAGINA];
+
+    if (!posicionar(f, deslocamento) || fread(atual, 1, sizeof(atual), f) != sizeof(atual)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < sizeof(atual); i++) {
+        atual[i] &= pagina[i];
+    }
+    return posicionar(f, deslocamento) &&
+           fwrite(atual, 1, sizeof(atual), f) == sizeof(atual) &&
+           fflush(f) == 0;
+}
+
+/**
+ * @brief Abre (ou cria apagado) o arquivo com `n_setores` setores e preenche `backend`.
+ */
+bool backend_flash_arquivo_abrir(BackendFlash *backend, const char *caminho, uint32_t n_setores) {
+    FILE *f = fopen(caminho, "r+b");
+    if (!f) {
+        f = fopen(caminho, "w+b");
+        if (!f) {
+            return false;
+        }
+    }
+
+    // Completa com setores apagados se o arquivo for novo ou menor que a região
+    uint32_t tam_regiao = n_setores * REGISTRO_FLASH_TAM_SETOR;
+    fseek(f, 0, SEEK_END);
+    long tam_atual = ftell(f);
+    for (long i = tam_atual; i < (long)tam_regiao; i++) {
+        fputc(0xFF, f);
+    }
+    fflush(f);
+
+    *backend = (BackendFlash){
+        .tam_setor = REGISTRO_FLASH_TAM_SETOR,
+        .tam_pagina = REGISTRO_FLASH_TAM_PAGINA,
+        .n_setores = n_setores,
+        .ler = ler,
+        .gravar_setor = gravar_setor,
+        .programar_pagina = programar_pagina,
+        .ctx = f,
+    };
+    return true;
+}
+
+void backend_flash_arquivo_fechar(BackendFlash *backend) {
+    if (backend->ctx) {
+        fclose((FILE *)backend->ctx);
+        backend->ctx = NULL;
+    }
+}
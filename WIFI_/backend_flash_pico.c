@@ -0,0 +1,72 @@
+/**
+ * @file backend_flash_pico.c
+ * @brief Backend de armazenamento na flash interna do Pico W.
+ *
+ * As escritas usam `flash_safe_execute()`, que pausa o outro núcleo e desabilita
+ * interrupções enquanto o XIP está desligado. Por isso o núcleo 1 precisa chamar
+ * `flash_safe_execute_core_init()` antes de qualquer gravação. A pausa troca palavras
+ * de controle pela FIFO do SIO, que por isso não carrega mensagens entre os núcleos.
+ */
+
+#include "backend_flash.h"
+#include "configura_geral.h"
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include <string.h>
+
+#define REGISTRO_FLASH_INICIO (PICO_FLASH_SIZE_BYTES - REGISTRO_FLASH_SETORES * FLASH_SECTOR_SIZE)
+#define REGISTRO_FLASH_TIMEOUT_MS 100
+
+typedef struct {
+    uint32_t deslocamento;
+    const uint8_t *dados;
+    uint32_t tamanho;
+    bool apagar;
+} OperacaoFlash;
+
+// Executada com o outro núcleo pausado e interrupções desabilitadas
+static void executar_operacao(void *param) {
+    OperacaoFlash *op = (OperacaoFlash *)param;
+    if (op->apagar) {
+        flash_range_erase(op->deslocamento, FLASH_SECTOR_SIZE);
+    }
+    flash_range_program(op->deslocamento, op->dados, op->tamanho);
+}
+
+static void ler(void *ctx, uint32_t deslocamento, void *destino, uint32_t tamanho) {
+    memcpy(destino, (const void *)(uintptr_t)(XIP_BASE + REGISTRO_FLASH_INICIO + deslocamento), tamanho);
+}
+
+static bool gravar_setor(void *ctx, uint32_t setor, const uint8_t *dados) {
+    OperacaoFlash op = {
+        .deslocamento = REGISTRO_FLASH_INICIO + setor * FLASH_SECTOR_SIZE,
+        .dados = dados,
+        .tamanho = FLASH_SECTOR_SIZE,
+        .apagar = true,
+    };
+    return flash_safe_execute(executar_operacao, &op, REGISTRO_FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+static bool programar_pagina(void *ctx, uint32_t deslocamento, const uint8_t *pagina) {
+    OperacaoFlash op = {
+        .deslocamento = REGISTRO_FLASH_INICIO + deslocamento,
+        .dados = pagina,
+        .tamanho = FLASH_PAGE_SIZE,
+        .apagar = false,
+    };
+    return flash_safe_execute(executar_operacao, &op, REGISTRO_FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+static const BackendFlash backend_pico = {
+    .tam_setor = FLASH_SECTOR_SIZE,
+    .tam_pagina = FLASH_PAGE_SIZE,
+    .n_setores = REGISTRO_FLASH_SETORES,
+    .ler = ler,
+    .gravar_setor = gravar_setor,
+    .programar_pagina = programar_pagina,
+    .ctx = NULL,
+};
+
+const BackendFlash *backend_flash_pico(void) {
+    return &backend_pico;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file brokers_mqtt.c
+ * @brief Implementação da seleção de broker por latência, com cache DNS e quarentena.
+ */
+
+#include "brokers_mqtt.h"
+#include "lwip/dns.h"
+#include "lwip/tcp.h"
+#include <string.h>
+
+typedef struct {
+    ConfigBroker cfg;
+    ip_addr_t ip;
+    bool resolvido;
+    bool resolvendo;
+    bool literal;                   // IP na configuração: não expira
+    absolute_time_t validade;       // Fim do TTL do endereço em cache
+
+    uint32_t latencia_us;           // Média móvel; 0 = ainda não medida
+    uint8_t falhas_seguidas;
+    absolute_time_t quarentena_ate;
+
+    struct tcp_pcb *sonda;
+    uint64_t sonda_inicio_us;
+} Broker;
+
+static const ConfigBroker config_brokers[] = MQTT_BROKERS;
+#define N_BROKERS ((int)(sizeof(config_brokers) / sizeof(config_brokers[0])))
+
+static Broker brokers[N_BROKERS];
+static absolute_time_t proxima_sondagem;
+
+static void registrar_latencia(Broker *b, uint32_t amostra_us) {
+    // Média móvel exponencial com peso 1/8 para a nova amostra
+    b->latencia_us = b->latencia_us ? (b->latencia_us * 7 + amostra_us) / 8 : amostra_us;
+}
+
+static void registrar_falha(Broker *b) {
+    if (++b->falhas_seguidas >= BROKER_MAX_FALHAS) {
+        b->quarentena_ate = make_timeout_time_ms(BROKER_QUARENTENA_MS);
+        printf("[BROKER] %s:%u em quarentena por %u ms\n",
+               b->cfg.host, b->cfg.porta, BROKER_QUARENTENA_MS);
+    }
+}
+
+// ========================
+// SONDAS TCP (contexto da lwIP)
+// ========================
+
+static err_t sonda_conectada_cb(void *arg, struct tcp_pcb *pcb, err_t err) {
+    Broker *b = (Broker *)arg;
+    registrar_latencia(b, (uint32_t)(time_us_64() - b->sonda_inicio_us));
+    b->falhas_seguidas = 0;
+    b->sonda = NULL;
+
+    // Só interessava o handshake: descarta a conexão sem FIN
+    tcp_arg(pcb, NULL);
+    tcp_abort(pcb);
+    return ERR_ABRT;
+}
+
+static void sonda_erro_cb(void *arg, err_t err) {
+    Broker *b = (Broker *)arg;
+    if (b) {
+        b->sonda = NULL;   // O PCB já foi liberado pela lwIP
+        registrar_falha(b);
+    }
+}
+
+static void sondar(Broker *b) {
+    if (b->sonda || !b->resolvido) {
+        return;
+    }
+    struct tcp_pcb *pcb = tcp_new_ip_type(IP_GET_TYPE(&b->ip));
+    if (!pcb) {
+        return;
+    }
+    tcp_arg(pcb, b);
+    tcp_err(pcb, sonda_erro_cb);
+    b->sonda_inicio_us = time_us_64();
+    if (tcp_connect(pcb, &b->ip, b->cfg.porta, sonda_conectada_cb) != ERR_OK) {
+        tcp_arg(pcb, NULL);
+        tcp_abort(pcb);
+        registrar_falha(b);
+        return;
+    }
+    b->sonda = pcb;
+}
+
+// ========================
+// DNS (contexto da lwIP)
+// ========================
+
+static void dns_encontrado_cb(const char *nome, const ip_addr_t *ip, void *arg) {
+    Broker *b = (Broker *)arg;
+    b->resolvendo = false;
+    if (!ip) {
+        printf("[BROKER] Falha ao resolver %s\n", nome);
+        registrar_falha(b);
+        return;
+    }
+    ip_addr_copy(b->ip, *ip);
+    b->resolvido = true;
+    b->validade = make_timeout_time_ms(BROKER_DNS_TTL_MS);
+    sondar(b);
+}
+
+static void resolver(Broker *b) {
+    if (b->resolvendo) {
+        return;
+    }
+    ip_addr_t ip;
+    err_t err = dns_gethostbyname(b->cfg.host, &ip, dns_encontrado_cb, b);
+    if (err == ERR_OK) {
+        // IP literal ou nome já no cache da lwIP
+        dns_encontrado_cb(b->cfg.host, &ip, b);
+    } else if (err == ERR_INPROGRESS) {
+        b->resolvendo = true;
+    } else {
+        registrar_falha(b);
+    }
+}
+
+// ========================
+// API
+// ========================
+
+void brokers_inicializar(void) {
+    memset(brokers, 0, sizeof(brokers));
+    for (int i = 0; i < N_BROKERS; i++) {
+        Broker *b = &brokers[i];
+        b->cfg = config_brokers[i];
+        if (ipaddr_aton(b->cfg.host, &b->ip)) {
+            b->literal = true;
+            b->resolvido = true;
+            sondar(b);
+        } else {
+            resolver(b);
+        }
+    }
+    proxima_sondagem = make_timeout_time_ms(BROKER_SONDAGEM_MS);
+}
+
+void brokers_processar(void) {
+    bool sondar_todos = time_reached(proxima_sondagem);
+    if (sondar_todos) {
+        proxima_sondagem = make_timeout_time_ms(BROKER_SONDAGEM_MS);
+    }
+
+    for (int i = 0; i < N_BROKERS; i++) {
+        Broker *b = &brokers[i];
+        if (!b->literal && (!b->resolvido || time_reached(b->validade))) {
+            resolver(b);  // O endereço antigo segue em uso até a resposta
+        }
+        if (b->sonda && time_us_64() - b->sonda_inicio_us > BROKER_SONDA_TIMEOUT_MS * 1000ull) {
+            tcp_abort(b->sonda);   // Chama sonda_erro_cb, que conta a falha
+        }
+        if (sondar_todos) {
+            sondar(b);
+        }
+    }
+}
+
+static bool utilizavel(const Broker *b) {
+    return b->resolvido && time_reached(b->quarentena_ate);
+}
+
+int brokers_escolher(void) {
+    int melhor = BROKER_NENHUM;
+    for (int i = 0; i < N_BROKERS; i++) {
+        const Broker *b = &brokers[i];
+        if (!utilizavel(b)) {
+            continue;
+        }
+        // Latência desconhecida conta como infinita: só é escolhido se não houver medido
+        uint32_t lat = b->latencia_us ? b->latencia_us : UINT32_MAX;
+        uint32_t lat_melhor = melhor == BROKER_NENHUM ? UINT32_MAX
+                              : (brokers[melhor].latencia_us ? brokers[melhor].latencia_us : UINT32_MAX);
+        if (melhor == BROKER_NENHUM || lat < lat_melhor) {
+            melhor = i;
+        }
+    }
+
+    if (melhor == BROKER_NENHUM) {
+        // Todos em quarentena: tenta o que sai dela primeiro, em vez de ficar parado
+        for (int i = 0; i < N_BROKERS; i++) {
+            if (brokers[i].resolvido &&
+                (melhor == BROKER_NENHUM ||
+                 absolute_time_diff_us(brokers[i].quarentena_ate, brokers[melhor].quarentena_ate) > 0)) {
+                melhor = i;
+            }
+        }
+    }
+    return melhor;
+}
+
+bool brokers_ha_alternativa(int atual) {
+    for (int i = 0; i < N_BROKERS; i++) {
+        if (i != atual && utilizavel(&brokers[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const ip_addr_t *brokers_endereco(int indice) { return &brokers[indice].ip; }
+uint16_t brokers_porta(int indice)            { return brokers[indice].cfg.porta; }
+const char *brokers_nome(int indice)          { return brokers[indice].cfg.host; }
+
+void brokers_registrar_sucesso(int indice, uint32_t latencia_us) {
+    Broker *b = &brokers[indice];
+    registrar_latencia(b, latencia_us);
+    b->falhas_seguidas = 0;
+}
+
+void brokers_registrar_falha(int indice) {
+    registrar_falha(&brokers[indice]);
+}
+
+void brokers_imprimir(void) {
+    for (int i = 0; i < N_BROKERS; i++) {
+        const Broker *b = &brokers[i];
+        printf("[BROKER] %s:%u %s latência %lu us, falhas %u%s\n",
+               b->cfg.host, b->cfg.porta, b->resolvido ? ipaddr_ntoa(&b->ip) : "(não resolvido)",
+               (unsigned long)b->latencia_us, b->falhas_seguidas,
+               time_reached(b->quarentena_ate) ? "" : " [quarentena]");
+    }
+}
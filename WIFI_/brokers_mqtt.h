@@ -0,0 +1,52 @@
+/**
+ * @file brokers_mqtt.h
+ * @brief Lista de brokers MQTT com resolução DNS assíncrona, sondagem de latência e failover.
+ *
+ * Cada broker de `MQTT_BROKERS` (nome ou IP) é resolvido com `dns_gethostbyname()`
+ * e o endereço fica em cache por `BROKER_DNS_TTL_MS`; vencido o prazo, o endereço
+ * antigo continua em uso enquanto uma nova consulta é feita.
+ *
+ * A latência de cada broker é estimada (média móvel exponencial) por sondas TCP
+ * (tempo até o SYN-ACK), repetidas a cada `BROKER_SONDAGEM_MS`, e pelo tempo até o
+ * CONNACK das conexões reais. `brokers_escolher()` devolve o broker saudável de menor
+ * latência; `BROKER_MAX_FALHAS` falhas seguidas põem o broker em quarentena por
+ * `BROKER_QUARENTENA_MS`, e a próxima tentativa vai para outro.
+ *
+ * Todas as funções devem ser chamadas com a trava da lwIP (os callbacks de DNS e das
+ * sondas rodam no contexto da pilha).
+ */
+
+#ifndef BROKERS_MQTT_H
+#define BROKERS_MQTT_H
+
+#include "configura_geral.h"
+#include "lwip/ip_addr.h"
+
+#define BROKER_NENHUM (-1)
+
+typedef struct {
+    const char *host;
+    uint16_t porta;
+} ConfigBroker;
+
+void brokers_inicializar(void);
+
+// Resolução vencida, sondas periódicas e timeout das sondas (supervisor)
+void brokers_processar(void);
+
+// Broker saudável de menor latência com endereço resolvido, ou BROKER_NENHUM
+int brokers_escolher(void);
+
+// Há outro broker utilizável além de `atual`?
+bool brokers_ha_alternativa(int atual);
+
+const ip_addr_t *brokers_endereco(int indice);
+uint16_t brokers_porta(int indice);
+const char *brokers_nome(int indice);
+
+void brokers_registrar_sucesso(int indice, uint32_t latencia_us);
+void brokers_registrar_falha(int indice);
+
+void brokers_imprimir(void);
+
+#endif
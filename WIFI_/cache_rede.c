@@ -0,0 +1,97 @@
+/**
+ * @file cache_rede.c
+ * @brief Persistência do cache de associação Wi-Fi em um setor da flash.
+ *
+ * A gravação usa `flash_safe_execute()`, que pausa o núcleo 1 trocando palavras pela
+ * FIFO do SIO; por isso as mensagens entre os núcleos não passam por ela
+ * (`protocolo_nucleos.h`). Se a pausa falhar (núcleo 1 não respondeu no prazo), o cache
+ * continua pendente e a gravação é tentada de novo após `CACHE_REDE_NOVA_TENTATIVA_MS`.
+ */
+
+#include "cache_rede.h"
+#include "configura_geral.h"
+#include "eventos.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "pico/flash.h"
+#include <stddef.h>
+#include <string.h>
+
+// Setor imediatamente abaixo do registro de publicações
+#define CACHE_REDE_INICIO (PICO_FLASH_SIZE_BYTES - (REGISTRO_FLASH_SETORES + 1) * FLASH_SECTOR_SIZE)
+#define CACHE_REDE_MAGICO 0x52454445u   // "REDE"
+#define CACHE_REDE_TIMEOUT_MS 100
+#define CACHE_REDE_NOVA_TENTATIVA_MS 1000
+
+_Static_assert(sizeof(CacheRede) <= FLASH_PAGE_SIZE, "cache deve caber em uma página");
+
+// Passagem núcleo 1 → núcleo 0
+static CacheRede pendente;
+static volatile bool ha_pendente = false;
+static alarm_id_t alarme_tentativa = 0;
+
+static uint32_t calcular_verificacao(const CacheRede *c) {
+    const uint8_t *p = (const uint8_t *)c;
+    uint32_t h = 2166136261u;   // FNV-1a sobre todos os campos antes de `verificacao`
+    for (size_t i = 0; i < offsetof(CacheRede, verificacao); i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+bool cache_rede_carregar(CacheRede *cache) {
+    memcpy(cache, (const void *)(uintptr_t)(XIP_BASE + CACHE_REDE_INICIO), sizeof(*cache));
+    if (cache->magico != CACHE_REDE_MAGICO || cache->verificacao != calcular_verificacao(cache)) {
+        memset(cache, 0, sizeof(*cache));
+        return false;
+    }
+    return true;
+}
+
+bool cache_rede_atualizar(const CacheRede *cache) {
+    if (ha_pendente) {
+        return false;
+    }
+    pendente = *cache;
+    pendente.magico = CACHE_REDE_MAGICO;
+    pendente.verificacao = calcular_verificacao(&pendente);
+    __dmb();
+    ha_pendente = true;
+    eventos_sinalizar(EVT_REDE);
+    return true;
+}
+
+// Executada com o outro núcleo pausado e interrupções desabilitadas
+static void gravar_pagina(void *param) {
+    flash_range_erase(CACHE_REDE_INICIO, FLASH_SECTOR_SIZE);
+    flash_range_program(CACHE_REDE_INICIO, (const uint8_t *)param, FLASH_PAGE_SIZE);
+}
+
+static int64_t alarme_tentativa_cb(alarm_id_t id, void *user_data) {
+    alarme_tentativa = 0;
+    eventos_sinalizar(EVT_REDE);
+    return 0;
+}
+
+void cache_rede_processar(void) {
+    if (!ha_pendente) {
+        return;
+    }
+    __dmb();
+    static uint8_t pagina[FLASH_PAGE_SIZE];
+    memset(pagina, 0xFF, sizeof(pagina));
+    memcpy(pagina, &pendente, sizeof(pendente));
+
+    // Evita apagar o setor quando nada mudou
+    if (memcmp(pagina, (const void *)(uintptr_t)(XIP_BASE + CACHE_REDE_INICIO), sizeof(CacheRede)) != 0 &&
+        flash_safe_execute(gravar_pagina, pagina, CACHE_REDE_TIMEOUT_MS) != PICO_OK) {
+        // Mantém o cache pendente (o núcleo 1 não o substitui enquanto isso)
+        printf("[WIFI] Falha ao gravar o cache de rede; nova tentativa em %u ms\n", CACHE_REDE_NOVA_TENTATIVA_MS);
+        if (!alarme_tentativa) {
+            alarme_tentativa = add_alarm_in_ms(CACHE_REDE_NOVA_TENTATIVA_MS, alarme_tentativa_cb, NULL, true);
+        }
+        return;
+    }
+    __dmb();
+    ha_pendente = false;
+}
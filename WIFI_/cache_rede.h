@@ -0,0 +1,40 @@
+/**
+ * @file cache_rede.h
+ * @brief Dados da última associação Wi-Fi bem-sucedida, persistidos na flash.
+ *
+ * Guarda o BSSID e o canal do ponto de acesso e o último lease DHCP (IP, máscara e
+ * gateway) em um setor logo abaixo do registro de publicações (`registro_flash.h`).
+ * Na partida e nas reconexões, o núcleo 1 entra diretamente nesse BSSID/canal, sem
+ * varredura, e pode aplicar o lease antes da resposta do DHCP.
+ *
+ * O núcleo 1 lê o setor diretamente (XIP) e entrega as atualizações ao núcleo 0,
+ * que é quem grava na flash (`EVT_REDE`), como no registro de publicações.
+ */
+
+#ifndef CACHE_REDE_H
+#define CACHE_REDE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t magico;
+    uint8_t bssid[6];
+    uint8_t canal;              // 0 = desconhecido
+    uint8_t tem_lease;
+    uint32_t ip;                // Ordem de rede (ip4_addr_t.addr)
+    uint32_t mascara;
+    uint32_t gateway;
+    uint32_t verificacao;       // Detecta setor apagado ou gravação interrompida
+} CacheRede;
+
+// Lê o cache da flash; false se não houver dados válidos
+bool cache_rede_carregar(CacheRede *cache);
+
+// Núcleo 1: entrega um cache novo para gravação. false se ainda houver outro pendente.
+bool cache_rede_atualizar(const CacheRede *cache);
+
+// Núcleo 0: grava o cache pendente, se diferente do que já está na flash
+void cache_rede_processar(void);
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file caixa_mensagens.c
+ * @brief Implementação da caixa de mensagens com coalescência por classe.
+ */
+
+#include "caixa_mensagens.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+void caixa_inicializar(CaixaMensagens *c) {
+    memset(c->posicoes, 0, sizeof(c->posicoes));
+    fila_inicializar(&c->ordenadas, c->buffer_ordenadas, sizeof(EntradaCaixa), TAM_FILA);
+    c->proxima_ordem = 0;
+    c->coalescidas = 0;
+    c->descartadas = 0;
+}
+
+/**
+ * @brief Mapeia o tipo da mensagem para sua classe na caixa.
+ */
+ClasseMensagem caixa_classe(uint8_t tipo) {
+    switch (tipo) {
+        case MSG_STATUS_WIFI: return CLASSE_STATUS_WIFI;
+        case MSG_IPV4:
+        case MSG_IPV6:        return CLASSE_IP;
+        case MSG_RSSI:        return CLASSE_RSSI;
+        default:              return CLASSE_ORDENADA;
+    }
+}
+
+/**
+ * @brief Deposita uma mensagem (lado produtor).
+ *
+ * @return false somente se uma mensagem ordenada foi descartada por falta de espaço.
+ */
+bool caixa_depositar(CaixaMensagens *c, const MensagemNucleo *msg) {
+    ClasseMensagem classe = caixa_classe(msg->tipo);
+    uint32_t ordem = c->proxima_ordem++;
+
+    if (classe == CLASSE_ORDENADA) {
+        EntradaCaixa entrada = {.ordem = ordem, .msg = *msg};
+        if (!fila_inserir(&c->ordenadas, &entrada)) {
+            c->descartadas++;
+            return false;
+        }
+        return true;
+    }
+
+    PosicaoCoalescente *pos = &c->posicoes[classe];
+    if (pos->ocupada) {
+        c->coalescidas++;
+    }
+    pos->entrada.ordem = ordem;
+    pos->entrada.msg = *msg;
+    pos->ocupada = true;
+    return true;
+}
+
+/**
+ * @brief Retira a mensagem pendente mais antiga entre todas as classes (lado consumidor).
+ */
+bool caixa_retirar(CaixaMensagens *c, MensagemNucleo *saida) {
+    EntradaCaixa frente;
+    bool tem_ordenada = fila_espiar(&c->ordenadas, &frente);
+
+    // As posições coalescentes são escritas pela IRQ: copia com IRQs desabilitadas
+    uint32_t estado_irq = save_and_disable_interrupts();
+
+    PosicaoCoalescente *escolhida = NULL;
+    for (int i = 0; i < CAIXA_N_CLASSES_COALESCENTES; i++) {
+        PosicaoCoalescente *pos = &c->posicoes[i];
+        if (pos->ocupada &&
+            (!escolhida || (int32_t)(pos->entrada.ordem - escolhida->entrada.ordem) < 0)) {
+            escolhida = pos;
+        }
+    }
+
+    if (escolhida && (!tem_ordenada || (int32_t)(escolhida->entrada.ordem - frente.ordem) < 0)) {
+        *saida = escolhida->entrada.msg;
+        escolhida->ocupada = false;
+        restore_interrupts(estado_irq);
+        return true;
+    }
+    restore_interrupts(estado_irq);
+
+    if (tem_ordenada) {
+        fila_remover(&c->ordenadas, &frente);
+        *saida = frente.msg;
+        return true;
+    }
+    return false;
+}
+
+uint32_t caixa_retirar_lote(CaixaMensagens *c, MensagemNucleo *saida, uint32_t max) {
+    uint32_t n = 0;
+    while (n < max && caixa_retirar(c, &saida[n])) {
+        n++;
+    }
+    return n;
+}
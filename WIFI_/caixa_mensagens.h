@@ -0,0 +1,58 @@
+/**
+ * @file caixa_mensagens.h
+ * @brief Caixa de mensagens com coalescência por classe ("a mais recente vence").
+ *
+ * Mensagens de estado (status Wi-Fi, IP, RSSI) ocupam uma posição fixa por classe:
+ * uma mensagem nova sobrescreve a pendente em O(1), pois só o valor mais recente
+ * interessa. Classes de eventos ordenados (ACK de publicação, timestamps) seguem
+ * em uma fila SPSC e, se ela encher, a mensagem nova é descartada.
+ *
+ * A retirada respeita a ordem de chegada entre as classes (número de ordem global).
+ *
+ * Contexto de uso: produtor e consumidor são o laço principal do núcleo 0 (o produtor
+ * esvazia o anel de `protocolo_nucleos.h` em `EVT_FIFO`); a retirada desabilita as
+ * IRQs apenas para copiar uma posição.
+ */
+
+#ifndef CAIXA_MENSAGENS_H
+#define CAIXA_MENSAGENS_H
+
+#include "fila_circular.h"
+#include "protocolo_nucleos.h"
+
+typedef enum {
+    CLASSE_STATUS_WIFI = 0,
+    CLASSE_IP,
+    CLASSE_RSSI,
+    CAIXA_N_CLASSES_COALESCENTES,
+    CLASSE_ORDENADA = CAIXA_N_CLASSES_COALESCENTES,
+} ClasseMensagem;
+
+typedef struct {
+    uint32_t ordem;
+    MensagemNucleo msg;
+} EntradaCaixa;
+
+typedef struct {
+    volatile bool ocupada;
+    EntradaCaixa entrada;
+} PosicaoCoalescente;
+
+typedef struct {
+    PosicaoCoalescente posicoes[CAIXA_N_CLASSES_COALESCENTES];
+    FilaCircular ordenadas;
+    EntradaCaixa buffer_ordenadas[TAM_FILA];
+    uint32_t proxima_ordem;
+
+    // Diagnóstico
+    volatile uint32_t coalescidas;   // Mensagens sobrescritas por outra mais recente
+    volatile uint32_t descartadas;   // Mensagens ordenadas perdidas por fila cheia
+} CaixaMensagens;
+
+void caixa_inicializar(CaixaMensagens *c);
+bool caixa_depositar(CaixaMensagens *c, const MensagemNucleo *msg);
+bool caixa_retirar(CaixaMensagens *c, MensagemNucleo *saida);
+uint32_t caixa_retirar_lote(CaixaMensagens *c, MensagemNucleo *saida, uint32_t max);
+ClasseMensagem caixa_classe(uint8_t tipo);
+
+#endif
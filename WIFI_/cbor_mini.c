@@ -0,0 +1,239 @@
+/**
+ * @file cbor_mini.c
+ * @brief Implementação do codificador e do decodificador CBOR mínimos.
+ *
+ * Não usa heap nem depende do Pico SDK: o mesmo arquivo serve ao firmware e a
+ * ferramentas no host.
+ */
+
+#include "cbor_mini.h"
+#include <string.h>
+
+// Tipos principais (3 bits mais altos do byte inicial)
+#define CBOR_MT_UINT    0x00
+#define CBOR_MT_NEGINT  0x20
+#define CBOR_MT_TEXTO   0x60
+#define CBOR_MT_ARRAY   0x80
+#define CBOR_MT_MAPA    0xA0
+#define CBOR_MT_SIMPLES 0xE0
+
+#define CBOR_FALSO      0xF4
+#define CBOR_VERDADEIRO 0xF5
+#define CBOR_NULO_BYTE  0xF6
+#define CBOR_FLOAT32    0xFA
+
+void cbor_iniciar(CborEscritor *w, uint8_t *buf, size_t cap) {
+    w->buf = buf;
+    w->cap = cap;
+    w->pos = 0;
+    w->estouro = false;
+}
+
+static bool reservar(CborEscritor *w, size_t n) {
+    if (w->estouro || w->pos + n > w->cap) {
+        w->estouro = true;
+        return false;
+    }
+    return true;
+}
+
+// Escreve o cabeçalho (tipo principal + argumento) na forma mais curta possível
+static void escrever_cabecalho(CborEscritor *w, uint8_t tipo, uint64_t arg) {
+    if (arg < 24) {
+        if (reservar(w, 1)) {
+            w->buf[w->pos++] = tipo | (uint8_t)arg;
+        }
+    } else if (arg <= 0xFF) {
+        if (reservar(w, 2)) {
+            w->buf[w->pos++] = tipo | 24;
+            w->buf[w->pos++] = (uint8_t)arg;
+        }
+    } else if (arg <= 0xFFFF) {
+        if (reservar(w, 3)) {
+            w->buf[w->pos++] = tipo | 25;
+            w->buf[w->pos++] = (uint8_t)(arg >> 8);
+            w->buf[w->pos++] = (uint8_t)arg;
+        }
+    } else if (arg <= 0xFFFFFFFFu) {
+        if (reservar(w, 5)) {
+            w->buf[w->pos++] = tipo | 26;
+            for (int desloc = 24; desloc >= 0; desloc -= 8) {
+                w->buf[w->pos++] = (uint8_t)(arg >> desloc);
+            }
+        }
+    } else {
+        if (reservar(w, 9)) {
+            w->buf[w->pos++] = tipo | 27;
+            for (int desloc = 56; desloc >= 0; desloc -= 8) {
+                w->buf[w->pos++] = (uint8_t)(arg >> desloc);
+            }
+        }
+    }
+}
+
+void cbor_mapa(CborEscritor *w, uint32_t n_pares)   { escrever_cabecalho(w, CBOR_MT_MAPA, n_pares); }
+void cbor_array(CborEscritor *w, uint32_t n_itens)  { escrever_cabecalho(w, CBOR_MT_ARRAY, n_itens); }
+void cbor_u32(CborEscritor *w, uint32_t v)          { escrever_cabecalho(w, CBOR_MT_UINT, v); }
+void cbor_u64(CborEscritor *w, uint64_t v)          { escrever_cabecalho(w, CBOR_MT_UINT, v); }
+
+void cbor_i32(CborEscritor *w, int32_t v) {
+    if (v >= 0) {
+        escrever_cabecalho(w, CBOR_MT_UINT, (uint64_t)v);
+    } else {
+        // Inteiro negativo n é codificado como -1 - n
+        escrever_cabecalho(w, CBOR_MT_NEGINT, (uint64_t)(-1 - (int64_t)v));
+    }
+}
+
+void cbor_float(CborEscritor *w, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    if (reservar(w, 5)) {
+        w->buf[w->pos++] = CBOR_FLOAT32;
+        for (int desloc = 24; desloc >= 0; desloc -= 8) {
+            w->buf[w->pos++] = (uint8_t)(bits >> desloc);
+        }
+    }
+}
+
+void cbor_bool(CborEscritor *w, bool v) {
+    if (reservar(w, 1)) {
+        w->buf[w->pos++] = v ? CBOR_VERDADEIRO : CBOR_FALSO;
+    }
+}
+
+void cbor_texto(CborEscritor *w, const char *s) {
+    size_t n = strlen(s);
+    escrever_cabecalho(w, CBOR_MT_TEXTO, n);
+    if (reservar(w, n)) {
+        memcpy(&w->buf[w->pos], s, n);
+        w->pos += n;
+    }
+}
+
+// ========================
+// DECODIFICADOR
+// ========================
+
+void cbor_leitor_iniciar(CborLeitor *r, const uint8_t *buf, size_t tam) {
+    r->buf = buf;
+    r->tam = tam;
+    r->pos = 0;
+}
+
+// Lê o argumento de `n` bytes em big-endian
+static bool ler_argumento(CborLeitor *r, uint8_t info, uint64_t *arg) {
+    size_t n;
+    if (info < 24) {
+        *arg = info;
+        return true;
+    }
+    switch (info) {
+        case 24: n = 1; break;
+        case 25: n = 2; break;
+        case 26: n = 4; break;
+        case 27: n = 8; break;
+        default: return false;  // Comprimento indefinido não é suportado
+    }
+    if (n > r->tam - r->pos) {
+        return false;
+    }
+    *arg = 0;
+    for (size_t i = 0; i < n; i++) {
+        *arg = (*arg << 8) | r->buf[r->pos++];
+    }
+    return true;
+}
+
+/**
+ * @brief Lê o próximo item. Mapas e arrays retornam apenas o cabeçalho (quantidade);
+ *        seus elementos vêm nas chamadas seguintes.
+ */
+bool cbor_ler(CborLeitor *r, CborItem *item) {
+    item->tipo = CBOR_INVALIDO;
+    if (r->pos >= r->tam) {
+        return false;
+    }
+
+    uint8_t inicial = r->buf[r->pos++];
+    uint8_t tipo = inicial & 0xE0;
+    uint8_t info = inicial & 0x1F;
+    uint64_t arg;
+
+    if (tipo == CBOR_MT_SIMPLES) {
+        switch (inicial) {
+            case CBOR_FALSO:      item->tipo = CBOR_BOOL; item->b = false; return true;
+            case CBOR_VERDADEIRO: item->tipo = CBOR_BOOL; item->b = true;  return true;
+            case CBOR_NULO_BYTE:  item->tipo = CBOR_NULO; return true;
+            case CBOR_FLOAT32: {
+                uint64_t bits;
+                if (!ler_argumento(r, 26, &bits)) {
+                    return false;
+                }
+                uint32_t bits32 = (uint32_t)bits;
+                memcpy(&item->f, &bits32, sizeof(item->f));
+                item->tipo = CBOR_FLOAT;
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    if (!ler_argumento(r, info, &arg)) {
+        return false;
+    }
+
+    switch (tipo) {
+        case CBOR_MT_UINT:
+            item->tipo = CBOR_UINT;
+            item->u = arg;
+            return true;
+        case CBOR_MT_NEGINT:
+            if (arg > INT64_MAX) {
+                return false;   // Abaixo de INT64_MIN: não cabe em `i`
+            }
+            item->tipo = CBOR_NEGINT;
+            item->i = -1 - (int64_t)arg;
+            return true;
+        case CBOR_MT_TEXTO:
+            // r->pos <= r->tam aqui; `r->pos + arg` poderia dar a volta com um tamanho enorme
+            if (arg > r->tam - r->pos) {
+                return false;
+            }
+            item->tipo = CBOR_TEXTO;
+            item->texto.ptr = (const char *)&r->buf[r->pos];
+            item->texto.tam = (size_t)arg;
+            r->pos += (size_t)arg;
+            return true;
+        case CBOR_MT_ARRAY:
+            item->tipo = CBOR_ARRAY;
+            item->u = arg;
+            return true;
+        case CBOR_MT_MAPA:
+            item->tipo = CBOR_MAPA;
+            item->u = arg;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Lê um item que deve ser inteiro (positivo ou negativo).
+ */
+bool cbor_ler_inteiro(CborLeitor *r, int64_t *valor) {
+    CborItem item;
+    if (!cbor_ler(r, &item)) {
+        return false;
+    }
+    if (item.tipo == CBOR_UINT && item.u <= INT64_MAX) {
+        *valor = (int64_t)item.u;
+        return true;
+    }
+    if (item.tipo == CBOR_NEGINT) {
+        *valor = item.i;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file cbor_mini.h
+ * @brief Codificador CBOR (RFC 8949) mínimo, sem alocação, e decodificador correspondente.
+ *
+ * O codificador escreve campos tipados (inteiros, float, bool, textos curtos, mapas
+ * e arrays) diretamente em um buffer fornecido pelo chamador, em uma única passada.
+ * Se o buffer acabar, o escritor marca `estouro` e ignora as escritas seguintes;
+ * basta verificar `cbor_ok()` ao final.
+ *
+ * O decodificador não depende do Pico SDK e pode ser compilado no host para ler as
+ * mensagens publicadas pelo dispositivo (ex.: em um assinante MQTT de teste).
+ *
+ * Comparação com os payloads textuais anteriores:
+ * - "Pico W online" (13 bytes)  → {TEL_ONLINE: true}        (3 bytes)
+ * - "rssi=-52"      (8 bytes)   → {TEL_RSSI: -52}           (4 bytes)
+ */
+
+#ifndef CBOR_MINI_H
+#define CBOR_MINI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ========================
+// CODIFICADOR
+// ========================
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t pos;
+    bool estouro;
+} CborEscritor;
+
+void cbor_iniciar(CborEscritor *w, uint8_t *buf, size_t cap);
+void cbor_mapa(CborEscritor *w, uint32_t n_pares);
+void cbor_array(CborEscritor *w, uint32_t n_itens);
+void cbor_u32(CborEscritor *w, uint32_t v);
+void cbor_u64(CborEscritor *w, uint64_t v);
+void cbor_i32(CborEscritor *w, int32_t v);
+void cbor_float(CborEscritor *w, float v);
+void cbor_bool(CborEscritor *w, bool v);
+void cbor_texto(CborEscritor *w, const char *s);
+
+static inline bool cbor_ok(const CborEscritor *w) { return !w->estouro; }
+static inline size_t cbor_tamanho(const CborEscritor *w) { return w->pos; }
+
+// ========================
+// DECODIFICADOR
+// ========================
+
+typedef enum {
+    CBOR_UINT,
+    CBOR_NEGINT,
+    CBOR_TEXTO,
+    CBOR_ARRAY,
+    CBOR_MAPA,
+    CBOR_FLOAT,
+    CBOR_BOOL,
+    CBOR_NULO,
+    CBOR_INVALIDO,
+} CborTipo;
+
+typedef struct {
+    CborTipo tipo;
+    union {
+        uint64_t u;          // CBOR_UINT; número de itens em CBOR_ARRAY / pares em CBOR_MAPA
+        int64_t i;           // CBOR_NEGINT
+        float f;             // CBOR_FLOAT
+        bool b;              // CBOR_BOOL
+        struct {
+            const char *ptr; // Aponta para dentro do buffer (não terminado em '\0')
+            size_t tam;
+        } texto;
+    };
+} CborItem;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t tam;
+    size_t pos;
+} CborLeitor;
+
+void cbor_leitor_iniciar(CborLeitor *r, const uint8_t *buf, size_t tam);
+bool cbor_ler(CborLeitor *r, CborItem *item);
+bool cbor_ler_inteiro(CborLeitor *r, int64_t *valor);
+
+// ========================
+// CHAVES DOS MAPAS DE TELEMETRIA
+// ========================
+
+typedef enum {
+    TEL_ONLINE          = 1,   // bool: dispositivo conectado ao broker
+    TEL_RSSI            = 2,   // int: RSSI em dBm
+    TEL_STATUS_WIFI     = 3,   // uint: 0 inicializando, 1 conectado, 2 falha
+    TEL_SEQ             = 4,   // uint: número de sequência
+    TEL_INSTANTE_US     = 5,   // uint: time_us_64() do emissor
+    TEL_RTT_P50_US      = 6,   // uint: mediana do RTT do PING
+    TEL_RTT_P99_US      = 7,   // uint: percentil 99 do RTT do PING
+    TEL_PING_PERDIDOS   = 8,   // uint: PINGs sem eco
+    TEL_PING_FORA_ORDEM = 9,   // uint: ecos recebidos fora de ordem
+} ChaveTelemetria;
+
+#endif
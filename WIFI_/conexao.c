@@ -1,13 +1,30 @@
 /**
  * @file conexao.c
- * @brief Núcleo 1 - Cliente Wi-Fi com reconexão automática e envio via FIFO.
+ * @brief Núcleo 1 - Cliente Wi-Fi com reconexão automática e envio ao núcleo 0 (`protocolo_nucleos.h`).
  * Envia status da conexão (azul, verde, vermelho), número da tentativa e IP ao núcleo 0.
+ *
+ * A conexão é uma máquina de estados sem esperas bloqueantes: cada passo (início da
+ * associação, consulta do enlace, backoff, verificação periódica) é agendado em um
+ * alarme do próprio núcleo 1, e o laço dorme em WFE entre os passos.
+ *
+ * A entrada na rede usa primeiro o BSSID e o canal da última associação (`cache_rede.h`),
+ * sem varredura, e o último lease DHCP como endereço provisório; a varredura completa
+ * fica para quando o ponto de acesso em cache não responde.
  */
 
 #include "conexao.h"
 #include "wifi_status.h"
+#include "protocolo_nucleos.h"
 #include "pico/cyw43_arch.h"
 #include "pico/multicore.h"
+#include "pico/flash.h"
+#include "hardware/sync.h"
+#include "cache_rede.h"
+#include "nucleo_rede.h"
+#include "rastro_boot.h"
+#include "lwip/netif.h"
+#include "lwip/dhcp.h"
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -19,91 +36,341 @@ bool wifi_esta_conectado(void) {
 }
 
 void enviar_status_para_core0(uint16_t status, uint16_t tentativa) {
-    uint32_t pacote = ((tentativa & 0xFFFF) << 16) | (status & 0xFFFF);
-    multicore_fifo_push_blocking(pacote);
+    protocolo_enviar_status_wifi(status, tentativa);
 }
 
 void enviar_ip_para_core0(uint8_t *ip) {
     uint32_t ip_bin = (ip[0] << 24) | (ip[1] << 16) | (ip[2] << 8) | ip[3];
-    // Usa tentativa = 0xFFFE para indicar pacote de IP
-    uint32_t pacote = (0xFFFE << 16) | 0;
-    multicore_fifo_push_blocking(pacote);
-    multicore_fifo_push_blocking(ip_bin);
+    protocolo_enviar_ipv4(ip_bin);
+
+    // Envia também a intensidade do sinal da associação recém-estabelecida
+    int32_t rssi;
+    if (cyw43_wifi_get_rssi(&cyw43_state, &rssi) == 0) {
+        protocolo_enviar_rssi(rssi);
+    }
 }
 
+// ========================
+// REENTRADA RÁPIDA (BSSID/canal e lease em cache)
+// ========================
 
-void conectar_wifi(void) {
-    status_wifi_rgb = 0;
-    enviar_status_para_core0(status_wifi_rgb, 0); // inicializando
-    
+#ifndef CYW43_IOCTL_GET_CHANNEL
+#define CYW43_IOCTL_GET_CHANNEL 0x3a
+#endif
 
-    if (cyw43_arch_init()) {
-        status_wifi_rgb = 2;
-        enviar_status_para_core0(status_wifi_rgb, 0); // falha init
+static CacheRede cache;
+static bool cache_bssid_valido = false;   // Falha no BSSID em cache volta à varredura
+static uint32_t ip_enviado = 0;
+static bool lease_registrado = false;     // Lease do DHCP desta associação já no cache
+
+static struct netif *netif_sta(void) {
+    return &cyw43_state.netif[CYW43_ITF_STA];
+}
+
+static uint8_t canal_atual(void) {
+    uint32_t info[3] = {0};   // channel_info_t: hw_channel, target_channel, scan_channel
+    if (cyw43_ioctl(&cyw43_state, CYW43_IOCTL_GET_CHANNEL, sizeof(info), (uint8_t *)info, CYW43_ITF_STA) != 0) {
+        return 0;
+    }
+    return (uint8_t)info[0];
+}
+
+// Aplica um endereço sem esperar o DHCP, que segue ativo e o substitui ao responder
+static void aplicar_endereco(uint32_t ip, uint32_t mascara, uint32_t gateway, const char *origem) {
+    ip4_addr_t a, m, g;
+    ip4_addr_set_u32(&a, ip);
+    ip4_addr_set_u32(&m, mascara);
+    ip4_addr_set_u32(&g, gateway);
+
+    nucleo_rede_travar();
+    netif_set_addr(netif_sta(), &a, &m, &g);
+    nucleo_rede_destravar();
+    printf("[WIFI] Endereço %s aplicado: %s\n", origem, ip4addr_ntoa(&a));
+}
+
+// Associado sem IP: lease em cache (de imediato ou após WIFI_TIMEOUT_DHCP_MS) ou IP fixo
+static bool aplicar_endereco_provisorio(uint32_t ms_sem_ip) {
+    if (cache.tem_lease && (WIFI_REUSAR_LEASE || ms_sem_ip >= WIFI_TIMEOUT_DHCP_MS)) {
+        aplicar_endereco(cache.ip, cache.mascara, cache.gateway, "do lease em cache");
+        return true;
+    }
+#ifdef WIFI_IP_FIXO
+    if (ms_sem_ip >= WIFI_TIMEOUT_DHCP_MS) {
+        ip4_addr_t a, m, g;
+        ip4addr_aton(WIFI_IP_FIXO, &a);
+        ip4addr_aton(WIFI_MASCARA_FIXA, &m);
+        ip4addr_aton(WIFI_GATEWAY_FIXO, &g);
+        aplicar_endereco(ip4_addr_get_u32(&a), ip4_addr_get_u32(&m), ip4_addr_get_u32(&g), "fixo");
+        return true;
+    }
+#endif
+    return false;
+}
+
+// Atualiza o cache com a associação atual (e o lease, quando vier do DHCP)
+static void registrar_associacao(void) {
+    CacheRede novo = cache;
+    if (cyw43_wifi_get_bssid(&cyw43_state, novo.bssid) != 0) {
         return;
     }
+    novo.canal = canal_atual();
 
-    cyw43_arch_enable_sta_mode();
+    nucleo_rede_travar();
+    struct netif *n = netif_sta();
+    bool do_dhcp = dhcp_supplied_address(n);
+    if (do_dhcp) {
+        novo.tem_lease = 1;
+        novo.ip = ip4_addr_get_u32(netif_ip4_addr(n));
+        novo.mascara = ip4_addr_get_u32(netif_ip4_netmask(n));
+        novo.gateway = ip4_addr_get_u32(netif_ip4_gw(n));
+    }
+    nucleo_rede_destravar();
 
-    for (uint16_t tentativa = 1; tentativa <= 5; tentativa++) {
-        int result = cyw43_arch_wifi_connect_timeout_ms(
-            WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_AES_PSK, 3000);
+    cache_bssid_valido = true;
+    bool gravado = memcmp(&novo, &cache, offsetof(CacheRede, verificacao)) == 0;
+    if (!gravado && cache_rede_atualizar(&novo)) {
+        cache = novo;
+        gravado = true;
+    }
+    // Sem lease do DHCP (ou gravação ainda ocupada), tenta de novo na próxima verificação
+    lease_registrado = do_dhcp && gravado;
+}
+
+// IP novo (associação ou DHCP que substituiu o endereço provisório) vai ao núcleo 0
+static void enviar_ip_se_mudou(void) {
+    uint32_t ip = ip4_addr_get_u32(netif_ip4_addr(netif_sta()));
+    if (ip && ip != ip_enviado) {
+        ip_enviado = ip;
+        enviar_ip_para_core0((uint8_t *)&ip);
+    }
+}
 
-        bool conectado = (result == 0) && wifi_esta_conectado();
-        status_wifi_rgb = conectado ? 1 : 2;
-        enviar_status_para_core0(status_wifi_rgb, tentativa);
+// ========================
+// MÁQUINA DE ESTADOS
+// ========================
 
-        if (conectado) {
-            uint8_t *ip = (uint8_t*)&cyw43_state.netif[0].ip_addr.addr;
-            enviar_ip_para_core0(ip);
-            return;
-        }
+typedef enum {
+    WIFI_PARADO = 0,
+    WIFI_ASSOCIANDO_DIRECIONADO,   // Entrada direta no BSSID/canal em cache
+    WIFI_ASSOCIANDO,               // Entrada com varredura completa
+    WIFI_CONECTADO,
+    WIFI_AGUARDANDO,               // Backoff entre tentativas
+} EstadoWifi;
 
-        sleep_ms(TEMPO_CONEXAO);
+static EstadoWifi estado = WIFI_PARADO;
+static uint16_t tentativa = 0;
+static uint64_t prazo_us = 0;           // Fim da etapa de associação atual
+static uint64_t associado_us = 0;       // Associado sem IP desde este instante (0 = não)
+static bool endereco_provisorio = false;
+static bool primeira_conexao = true;
+static uint64_t queda_us = 0;
+
+// Temporização do núcleo 1: alarme no pool próprio (IRQ neste núcleo) que só acorda o laço
+static alarm_pool_t *pool_nucleo1;
+static alarm_id_t alarme_passo = 0;
+static volatile bool passo_pendente = false;
+
+static int64_t alarme_passo_cb(alarm_id_t id, void *user_data) {
+    alarme_passo = 0;
+    passo_pendente = true;
+    __sev();
+    return 0;
+}
+
+static void agendar_passo(uint32_t atraso_ms) {
+    if (alarme_passo) {
+        alarm_pool_cancel_alarm(pool_nucleo1, alarme_passo);
     }
+    alarme_passo = alarm_pool_add_alarm_in_ms(pool_nucleo1, atraso_ms, alarme_passo_cb, NULL, true);
+}
+
+static uint64_t prazo_em_ms(uint32_t ms) {
+    return time_us_64() + (uint64_t)ms * 1000;
+}
+
+// Inicia uma tentativa: direto no BSSID em cache, se houver, senão com varredura
+static void iniciar_tentativa(void) {
+    tentativa++;
+    associado_us = 0;
+    endereco_provisorio = false;
+
+    if (cache_bssid_valido &&
+        cyw43_wifi_join(&cyw43_state, strlen(WIFI_SSID), (const uint8_t *)WIFI_SSID,
+                        strlen(WIFI_PASS), (const uint8_t *)WIFI_PASS, CYW43_AUTH_WPA2_AES_PSK,
+                        cache.bssid, cache.canal ? cache.canal : CYW43_CHANNEL_NULL) == 0) {
+        estado = WIFI_ASSOCIANDO_DIRECIONADO;
+        prazo_us = prazo_em_ms(WIFI_TIMEOUT_DIRECIONADO_MS);
+    } else if (cyw43_arch_wifi_connect_async(WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_AES_PSK) == 0) {
+        estado = WIFI_ASSOCIANDO;
+        prazo_us = prazo_em_ms(WIFI_TIMEOUT_ASSOCIACAO_MS);
+    } else {
+        prazo_us = 0;   // Falha imediata: tratada no próximo passo
+        estado = WIFI_ASSOCIANDO;
+    }
+    agendar_passo(WIFI_PASSO_ESPERA_MS);
+}
+
+/**
+ * @brief Tentativa sem sucesso: reporta ao núcleo 0 e agenda a próxima com backoff.
+ *
+ * O atraso dobra a cada tentativa, de `TEMPO_CONEXAO` até `WIFI_BACKOFF_MAX_MS`. Após
+ * `WIFI_MAX_TENTATIVAS` o núcleo 0 recebe a falha final, mas as tentativas continuam.
+ */
+static void falhar_tentativa(void) {
+    cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
 
     status_wifi_rgb = 2;
-    enviar_status_para_core0(status_wifi_rgb, 0);
+    enviar_status_para_core0(status_wifi_rgb, tentativa);
+    if (tentativa == WIFI_MAX_TENTATIVAS) {
+        enviar_status_para_core0(status_wifi_rgb, 0);
+    }
+
+    uint32_t atraso = TEMPO_CONEXAO;
+    for (uint16_t i = 1; i < tentativa && atraso < WIFI_BACKOFF_MAX_MS; i++) {
+        atraso *= 2;
+    }
+    if (atraso > WIFI_BACKOFF_MAX_MS) {
+        atraso = WIFI_BACKOFF_MAX_MS;
+    }
+    estado = WIFI_AGUARDANDO;
+    agendar_passo(atraso);
 }
 
-void monitorar_conexao_e_reconectar(void) {
-    while (true) {
-        sleep_ms(TEMPO_CONEXAO);
+static void concluir_conexao(bool direcionado) {
+    status_wifi_rgb = 1;
+    enviar_status_para_core0(status_wifi_rgb, tentativa);
 
-        if (!wifi_esta_conectado()) {
-            status_wifi_rgb = 2;
-            enviar_status_para_core0(status_wifi_rgb, 0);
+    if (primeira_conexao) {
+        primeira_conexao = false;
+        rastro_boot_marcar(BOOT_IP);
+        printf("[WIFI] Boot → IP: %lu ms (%s)\n", (unsigned long)(time_us_64() / 1000),
+               direcionado ? "BSSID em cache" : "varredura");
+    } else {
+        printf("[WIFI] Reconectado em %lu ms (%s)\n", (unsigned long)((time_us_64() - queda_us) / 1000),
+               direcionado ? "BSSID em cache" : "varredura");
+        // O IP é reenviado mesmo se igual: o núcleo 0 retoma o MQTT sem esperar o backoff
+        ip_enviado = 0;
+    }
+    enviar_ip_se_mudou();
+    lease_registrado = false;
+    registrar_associacao();
 
-            cyw43_arch_enable_sta_mode();
+    tentativa = 0;
+    estado = WIFI_CONECTADO;
+    agendar_passo(WIFI_VERIFICACAO_MS);
+}
 
-            for (uint16_t tentativa = 1; tentativa <= 5; tentativa++) {
-                int result = cyw43_arch_wifi_connect_timeout_ms(
-                    WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_AES_PSK, TEMPO_CONEXAO);
+// Um passo da associação em andamento (consulta do estado do enlace)
+static void passo_associacao(void) {
+    bool direcionado = estado == WIFI_ASSOCIANDO_DIRECIONADO;
+    int enlace = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
 
-                bool reconectado = (result == 0) && wifi_esta_conectado();
-                status_wifi_rgb = reconectado ? 1 : 2;
-                enviar_status_para_core0(status_wifi_rgb, tentativa);
+    if (enlace == CYW43_LINK_NOIP || enlace == CYW43_LINK_UP) {
+        rastro_boot_marcar(BOOT_ENLACE);
+    }
+    if (enlace == CYW43_LINK_UP) {
+        concluir_conexao(direcionado);
+        return;
+    }
+
+    bool falhou = enlace == CYW43_LINK_FAIL || enlace == CYW43_LINK_NONET ||
+                  enlace == CYW43_LINK_BADAUTH || time_us_64() >= prazo_us;
+    if (falhou) {
+        if (direcionado) {
+            // Ponto de acesso em cache não respondeu: mesma tentativa, agora com varredura
+            printf("[WIFI] BSSID em cache não respondeu; varredura completa\n");
+            cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+            cache_bssid_valido = false;
+            tentativa--;
+            iniciar_tentativa();
+        } else {
+            falhar_tentativa();
+        }
+        return;
+    }
 
-                if (reconectado) {
-                    uint8_t *ip = (uint8_t*)&cyw43_state.netif[0].ip_addr.addr;
-                    enviar_ip_para_core0(ip);
+    // Associado sem IP: endereço provisório (lease em cache ou IP fixo)
+    if (enlace == CYW43_LINK_NOIP && !endereco_provisorio) {
+        if (!associado_us) {
+            associado_us = time_us_64();
+        }
+        endereco_provisorio = aplicar_endereco_provisorio((uint32_t)((time_us_64() - associado_us) / 1000));
+    }
+    agendar_passo(WIFI_PASSO_ESPERA_MS);
+}
 
-                    break;
-                }
+void wifi_iniciar(alarm_pool_t *pool) {
+    pool_nucleo1 = pool;
 
-                sleep_ms(TEMPO_CONEXAO);
-            }
+    status_wifi_rgb = 0;
+    enviar_status_para_core0(status_wifi_rgb, 0); // inicializando
 
-            if (!wifi_esta_conectado()) {
+    if (cyw43_arch_init()) {
+        status_wifi_rgb = 2;
+        enviar_status_para_core0(status_wifi_rgb, 0); // falha init
+        return;
+    }
+
+    cyw43_arch_enable_sta_mode();
+    cache_bssid_valido = cache_rede_carregar(&cache);
+    iniciar_tentativa();
+}
+
+/**
+ * @brief Avança a máquina de estados; não bloqueia.
+ *
+ * Cada chamada executa no máximo um passo e agenda o próximo em um alarme.
+ */
+void wifi_processar(void) {
+    if (!passo_pendente) {
+        return;
+    }
+    passo_pendente = false;
+
+    switch (estado) {
+        case WIFI_ASSOCIANDO_DIRECIONADO:
+        case WIFI_ASSOCIANDO:
+            passo_associacao();
+            break;
+
+        case WIFI_CONECTADO:
+            if (wifi_esta_conectado()) {
+                // Resposta tardia do DHCP: novo IP e lease a persistir
+                enviar_ip_se_mudou();
+                if (!lease_registrado) {
+                    registrar_associacao();
+                }
+                agendar_passo(WIFI_VERIFICACAO_MS);
+            } else {
+                queda_us = time_us_64();
                 status_wifi_rgb = 2;
                 enviar_status_para_core0(status_wifi_rgb, 0);
+                iniciar_tentativa();
             }
-        }
+            break;
+
+        case WIFI_AGUARDANDO:
+            iniciar_tentativa();
+            break;
+
+        case WIFI_PARADO:
+            break;
     }
 }
 
 // Função a ser chamada no núcleo 1
 void funcao_wifi_nucleo1(void) {
-    conectar_wifi();
-    monitorar_conexao_e_reconectar();
+    // Permite que o núcleo 0 pause este núcleo durante gravações na flash
+    flash_safe_execute_core_init();
+
+    // Alarmes disparados neste núcleo: passos do Wi-Fi e supervisão do MQTT
+    alarm_pool_t *pool = alarm_pool_create_with_unused_hardware_alarm(WIFI_MAX_ALARMES);
+    wifi_iniciar(pool);
+    nucleo_rede_iniciar_nucleo1(pool);
+
+    while (true) {
+        wifi_processar();
+        nucleo_rede_processar();   // Comandos do núcleo 0 e supervisor MQTT (dono da lwIP)
+        __wfe();   // Acordado pelos alarmes (__sev) ou por comandos do outro núcleo
+    }
 }
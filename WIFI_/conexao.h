@@ -8,8 +8,10 @@
 
 #include "configura_geral.h"
 
-void conectar_wifi(void);
-void monitorar_conexao_e_reconectar(void);
+// Inicializa o cyw43 e dispara a primeira tentativa de conexão (passos no pool do núcleo 1)
+void wifi_iniciar(alarm_pool_t *pool);
+// Executa o passo pendente da máquina de estados (não bloqueia)
+void wifi_processar(void);
 bool wifi_esta_conectado(void);
 void enviar_status_para_core0(uint16_t status, uint16_t tentativa);
 void enviar_ip_para_core0(uint8_t *ip);
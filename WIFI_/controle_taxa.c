@@ -0,0 +1,132 @@
+/**
+ * @file controle_taxa.c
+ * @brief Implementação do balde de fichas com ajuste AIMD guiado pelos buffers da lwIP.
+ */
+
+#include "controle_taxa.h"
+#include "lwip/apps/mqtt_priv.h"   // Anel de saída e PCB do cliente
+#include "lwip/altcp.h"
+#include "lwip/opt.h"
+#include <string.h>
+
+#define MILI 1000u                               // Fichas em milésimos
+#define CONTROLE_SNDBUF_MIN (TCP_SND_BUF / 4)    // Abaixo disto: congestionado
+
+static uint32_t taxa;                 // msgs/s
+static uint32_t fichas;               // Milésimos de ficha
+static uint64_t ultima_reposicao_us;
+static uint64_t ultimo_ajuste_us;     // Última redução ou aumento
+static bool congestionado_no_periodo;
+static bool limitando = false;        // Para relatar só as transições
+static EstatisticasTaxa est;
+
+void controle_taxa_inicializar(void) {
+    taxa = CONTROLE_TAXA_INICIAL;
+    fichas = CONTROLE_RAJADA * MILI;
+    ultima_reposicao_us = ultimo_ajuste_us = time_us_64();
+    congestionado_no_periodo = false;
+    limitando = false;
+    memset(&est, 0, sizeof(est));
+    est.taxa_atual = taxa;
+}
+
+static void reduzir_taxa(uint64_t agora) {
+    congestionado_no_periodo = true;
+    if (agora - ultimo_ajuste_us < CONTROLE_REDUCAO_MS * 1000ull) {
+        return;
+    }
+    taxa = taxa / 2 > CONTROLE_TAXA_MIN ? taxa / 2 : CONTROLE_TAXA_MIN;
+    ultimo_ajuste_us = agora;
+    est.reducoes++;
+    est.taxa_atual = taxa;
+}
+
+// Repõe fichas pelo tempo decorrido e aplica o aumento aditivo
+static void repor(uint64_t agora) {
+    uint64_t decorrido = agora - ultima_reposicao_us;
+    uint64_t novas = decorrido * taxa / 1000;   // us × msgs/s → milésimos de ficha
+    if (novas) {
+        fichas = fichas + novas > CONTROLE_RAJADA * MILI ? CONTROLE_RAJADA * MILI : fichas + (uint32_t)novas;
+        ultima_reposicao_us = agora;
+    }
+
+    if (agora - ultimo_ajuste_us >= 1000000) {
+        if (!congestionado_no_periodo && taxa < CONTROLE_TAXA_MAX) {
+            taxa = taxa + CONTROLE_TAXA_PASSO < CONTROLE_TAXA_MAX ? taxa + CONTROLE_TAXA_PASSO : CONTROLE_TAXA_MAX;
+            est.taxa_atual = taxa;
+        }
+        congestionado_no_periodo = false;
+        ultimo_ajuste_us = agora;
+    }
+}
+
+// Espaço livre no anel de saída do cliente MQTT (mesma conta de mqtt_ringbuf_len())
+static uint32_t livre_anel(mqtt_client_t *client) {
+    uint32_t put = client->output.put, get = client->output.get;
+    uint32_t ocupado = put >= get ? put - get : put + MQTT_OUTPUT_RINGBUF_SIZE - get;
+    return MQTT_OUTPUT_RINGBUF_SIZE - ocupado;
+}
+
+static void relatar(bool agora_limitando) {
+    if (agora_limitando != limitando) {
+        limitando = agora_limitando;
+        if (limitando) {
+            printf("[TAXA] Limitando publicações a %lu msgs/s\n", (unsigned long)taxa);
+        } else {
+            printf("[TAXA] Fim da limitação (%lu msgs/s)\n", (unsigned long)taxa);
+        }
+    }
+}
+
+uint32_t controle_taxa_permitir(mqtt_client_t *client, uint32_t tamanho, PrioridadePublicacao prioridade) {
+    uint64_t agora = time_us_64();
+    repor(agora);
+
+    if (livre_anel(client) < tamanho) {
+        // O anel esvazia à medida que o TCP aceita os dados: tenta logo em seguida
+        est.sem_espaco_anel++;
+        reduzir_taxa(agora);
+        relatar(true);
+        return MQTT_RETENTATIVA_MEM_MS * 1000;
+    }
+
+    bool congestionado = client->conn && altcp_sndbuf(client->conn) < CONTROLE_SNDBUF_MIN;
+    if (congestionado) {
+        reduzir_taxa(agora);
+    }
+
+    uint32_t necessario = MILI;
+    if (prioridade == PRIORIDADE_BAIXA) {
+        if (congestionado) {
+            est.adiadas_baixa++;
+            relatar(true);
+            return MQTT_RETENTATIVA_MEM_MS * 1000;
+        }
+        necessario += CONTROLE_RESERVA_ALTA * MILI;
+    }
+
+    if (fichas < necessario) {
+        if (prioridade == PRIORIDADE_BAIXA) {
+            est.adiadas_baixa++;
+        } else {
+            est.limitadas++;
+        }
+        relatar(true);
+        return (uint32_t)((uint64_t)(necessario - fichas) * 1000 / taxa) + 1;
+    }
+
+    relatar(false);
+    return 0;
+}
+
+void controle_taxa_consumir(void) {
+    fichas = fichas >= MILI ? fichas - MILI : 0;
+}
+
+void controle_taxa_congestionado(void) {
+    reduzir_taxa(time_us_64());
+}
+
+void controle_taxa_estatisticas(EstatisticasTaxa *saida) {
+    *saida = est;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file controle_taxa.h
+ * @brief Controle de taxa de publicação com balde de fichas e ajuste AIMD.
+ *
+ * Antes de cada `mqtt_publish()`, a fila de saída consulta o controle, que verifica:
+ * - Espaço livre no anel de saída do cliente MQTT (`client->output`), evitando o ERR_MEM;
+ * - Espaço livre no buffer de envio TCP (`altcp_sndbuf()`): abaixo de 1/4 de
+ *   `TCP_SND_BUF` a conexão é considerada congestionada;
+ * - Fichas no balde, repostas à taxa atual (msgs/s).
+ *
+ * Congestionamento reduz a taxa pela metade (no máximo uma vez a cada
+ * `CONTROLE_REDUCAO_MS`); cada segundo sem congestionamento soma `CONTROLE_TAXA_PASSO`.
+ * Publicações de baixa prioridade só saem sem congestionamento e deixando
+ * `CONTROLE_RESERVA_ALTA` fichas para as de alta prioridade.
+ *
+ * Chamado apenas pela fila de publicação (sob a trava da lwIP).
+ */
+
+#ifndef CONTROLE_TAXA_H
+#define CONTROLE_TAXA_H
+
+#include "configura_geral.h"
+#include "lwip/apps/mqtt.h"
+
+typedef enum {
+    PRIORIDADE_ALTA = 0,
+    PRIORIDADE_BAIXA,
+} PrioridadePublicacao;
+
+typedef struct {
+    uint32_t taxa_atual;          // msgs/s
+    uint32_t limitadas;           // Envios adiados por falta de fichas
+    uint32_t adiadas_baixa;       // Baixa prioridade adiada (congestionamento ou reserva)
+    uint32_t sem_espaco_anel;     // Adiadas por falta de espaço no anel de saída
+    uint32_t reducoes;            // Reduções multiplicativas da taxa
+} EstatisticasTaxa;
+
+void controle_taxa_inicializar(void);
+
+/**
+ * @brief Decide se uma publicação pode sair agora.
+ *
+ * @param tamanho bytes do PUBLISH codificado (cabeçalho, tópico e payload)
+ * @return 0 se pode enviar; caso contrário, espera sugerida em microssegundos
+ */
+uint32_t controle_taxa_permitir(mqtt_client_t *client, uint32_t tamanho, PrioridadePublicacao prioridade);
+
+void controle_taxa_consumir(void);        // Publicação entregue à lwIP
+void controle_taxa_congestionado(void);   // ERR_MEM ou timeout de PUBACK
+
+void controle_taxa_estatisticas(EstatisticasTaxa *est);
+
+#endif
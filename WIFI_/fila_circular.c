@@ -1,47 +1,115 @@
 /**
  * @file fila_circular.c
- * @brief Implementação da fila circular com proteção por mutex.
+ * @brief Implementação da fila circular lock-free SPSC com índices em potência de dois.
+ *
+ * Os índices `cabeca` e `cauda` crescem livremente (aritmética módulo 2^32) e a
+ * diferença entre eles é a ocupação. O produtor grava o elemento, executa uma barreira
+ * (`__dmb`) e só então publica a nova `cabeca`; o consumidor lê a `cabeca`, executa a
+ * barreira e só então copia o elemento. Assim não há mutex nem desabilitação de IRQ.
  */
 
 #include "fila_circular.h"
+#include "hardware/sync.h"
+#include <string.h>
 
-void fila_inicializar(FilaCircular *f) {
-    f->frente = 0;
-    f->tras = -1;
-    f->tamanho = 0;
-    mutex_init(&f->mutex);
+void fila_inicializar(FilaCircular *f, void *buffer, size_t tam_elemento, uint32_t capacidade) {
+    // Capacidade inválida (não potência de dois) é erro de programação
+    assert(capacidade != 0 && (capacidade & (capacidade - 1)) == 0);
+
+    f->dados = (uint8_t *)buffer;
+    f->tam_elemento = (uint32_t)tam_elemento;
+    f->mascara = capacidade - 1;
+    f->cabeca = 0;
+    f->cauda = 0;
 }
 
-bool fila_inserir(FilaCircular *f, MensagemWiFi m) {
-    bool sucesso = false;
-    mutex_enter_blocking(&f->mutex);
+// Copia `quantidade` elementos para o anel a partir da posição `indice`, tratando a volta
+static void copiar_para_anel(FilaCircular *f, uint32_t indice, const uint8_t *origem, uint32_t quantidade) {
+    uint32_t pos = indice & f->mascara;
+    uint32_t ate_o_fim = f->mascara + 1 - pos;
+    uint32_t primeiro = quantidade < ate_o_fim ? quantidade : ate_o_fim;
 
-    if (f->tamanho < TAM_FILA) {
-        f->tras = (f->tras + 1) % TAM_FILA;
-        f->fila[f->tras] = m;
-        f->tamanho++;
-        sucesso = true;
+    memcpy(f->dados + pos * f->tam_elemento, origem, primeiro * f->tam_elemento);
+    if (quantidade > primeiro) {
+        memcpy(f->dados, origem + primeiro * f->tam_elemento, (quantidade - primeiro) * f->tam_elemento);
     }
+}
+
+// Copia `quantidade` elementos do anel a partir da posição `indice`, tratando a volta
+static void copiar_do_anel(const FilaCircular *f, uint32_t indice, uint8_t *destino, uint32_t quantidade) {
+    uint32_t pos = indice & f->mascara;
+    uint32_t ate_o_fim = f->mascara + 1 - pos;
+    uint32_t primeiro = quantidade < ate_o_fim ? quantidade : ate_o_fim;
 
-    mutex_exit(&f->mutex);
-    return sucesso;
+    memcpy(destino, f->dados + pos * f->tam_elemento, primeiro * f->tam_elemento);
+    if (quantidade > primeiro) {
+        memcpy(destino + primeiro * f->tam_elemento, f->dados, (quantidade - primeiro) * f->tam_elemento);
+    }
 }
 
-bool fila_remover(FilaCircular *f, MensagemWiFi *saida) {
-    bool sucesso = false;
-    mutex_enter_blocking(&f->mutex);
+uint32_t fila_inserir_lote(FilaCircular *f, const void *elementos, uint32_t quantidade) {
+    uint32_t cabeca = f->cabeca;
+    uint32_t cauda = f->cauda;
+    __dmb();  // Lê a cauda antes de sobrescrever posições liberadas pelo consumidor
 
-    if (f->tamanho > 0) {
-        *saida = f->fila[f->frente];
-        f->frente = (f->frente + 1) % TAM_FILA;
-        f->tamanho--;
-        sucesso = true;
+    uint32_t livres = (f->mascara + 1) - (cabeca - cauda);
+    if (quantidade > livres) {
+        quantidade = livres;
+    }
+    if (quantidade == 0) {
+        return 0;
+    }
+
+    copiar_para_anel(f, cabeca, (const uint8_t *)elementos, quantidade);
+    __dmb();  // Dados visíveis antes de publicar a nova cabeça
+    f->cabeca = cabeca + quantidade;
+    return quantidade;
+}
+
+uint32_t fila_remover_lote(FilaCircular *f, void *saida, uint32_t quantidade) {
+    uint32_t cauda = f->cauda;
+    uint32_t cabeca = f->cabeca;
+    __dmb();  // Lê a cabeça antes de ler os dados que ela publica
+
+    uint32_t ocupados = cabeca - cauda;
+    if (quantidade > ocupados) {
+        quantidade = ocupados;
+    }
+    if (quantidade == 0) {
+        return 0;
     }
 
-    mutex_exit(&f->mutex);
-    return sucesso;
+    copiar_do_anel(f, cauda, (uint8_t *)saida, quantidade);
+    __dmb();  // Cópia concluída antes de liberar as posições ao produtor
+    f->cauda = cauda + quantidade;
+    return quantidade;
+}
+
+bool fila_inserir(FilaCircular *f, const void *elemento) {
+    return fila_inserir_lote(f, elemento, 1) == 1;
+}
+
+bool fila_remover(FilaCircular *f, void *saida) {
+    return fila_remover_lote(f, saida, 1) == 1;
+}
+
+// Copia o elemento da frente sem removê-lo (somente o consumidor pode chamar)
+bool fila_espiar(const FilaCircular *f, void *saida) {
+    uint32_t cauda = f->cauda;
+    uint32_t cabeca = f->cabeca;
+    __dmb();
+
+    if (cabeca == cauda) {
+        return false;
+    }
+    copiar_do_anel(f, cauda, (uint8_t *)saida, 1);
+    return true;
+}
+
+uint32_t fila_ocupacao(const FilaCircular *f) {
+    return f->cabeca - f->cauda;
 }
 
-bool fila_vazia(FilaCircular *f) {
-    return f->tamanho == 0;
+bool fila_vazia(const FilaCircular *f) {
+    return f->cabeca == f->cauda;
 }
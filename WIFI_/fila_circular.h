@@ -1,30 +1,49 @@
 /**
  * @file fila_circular.h
- * @brief Interface da fila circular protegida por mutex para comunicação entre núcleos.
+ * @brief Interface da fila circular lock-free SPSC (um produtor, um consumidor) para comunicação entre núcleos.
+ *
+ * A fila não conhece o tipo da mensagem: ela armazena elementos de tamanho fixo em um
+ * buffer fornecido pelo chamador. A capacidade deve ser potência de dois, de modo que
+ * os índices avancem livremente e a posição seja obtida por máscara (sem divisão).
+ *
+ * Regras de uso:
+ * - Apenas um contexto (núcleo ou IRQ) pode inserir e apenas um pode remover;
+ * - `cabeca` é escrita somente pelo produtor e `cauda` somente pelo consumidor;
+ * - Barreiras de memória garantem que o dado seja visível antes do índice publicado.
  */
 #include "configura_geral.h"
 
 #ifndef FILA_CIRCULAR_H
 #define FILA_CIRCULAR_H
 
+#include <stddef.h>
 
+// A capacidade configurável precisa ser potência de dois
+_Static_assert((TAM_FILA & (TAM_FILA - 1)) == 0, "TAM_FILA deve ser potência de dois");
 
 typedef struct {
-    uint16_t tentativa;
-    uint16_t status;
-} MensagemWiFi;
-
-typedef struct {
-    MensagemWiFi fila[TAM_FILA];
-    int frente;
-    int tras;
-    int tamanho;
-    mutex_t mutex;
+    uint8_t *dados;              // Armazenamento fornecido pelo chamador (capacidade * tam_elemento)
+    uint32_t tam_elemento;       // Tamanho de cada elemento em bytes
+    uint32_t mascara;            // capacidade - 1
+    volatile uint32_t cabeca;    // Próxima posição de escrita (só o produtor altera)
+    volatile uint32_t cauda;     // Próxima posição de leitura (só o consumidor altera)
 } FilaCircular;
 
-void fila_inicializar(FilaCircular *f);
-bool fila_inserir(FilaCircular *f, MensagemWiFi m);
-bool fila_remover(FilaCircular *f, MensagemWiFi *saida);
-bool fila_vazia(FilaCircular *f);
+/**
+ * @brief Declara o armazenamento estático de uma fila para o tipo e capacidade informados.
+ *
+ * Ex.: `FILA_DECLARAR_BUFFER(buf_wifi, MensagemNucleo, TAM_FILA);`
+ */
+#define FILA_DECLARAR_BUFFER(nome, tipo, capacidade) \
+    static tipo nome[(capacidade)] __attribute__((aligned(4)))
+
+void fila_inicializar(FilaCircular *f, void *buffer, size_t tam_elemento, uint32_t capacidade);
+bool fila_inserir(FilaCircular *f, const void *elemento);
+bool fila_remover(FilaCircular *f, void *saida);
+bool fila_espiar(const FilaCircular *f, void *saida);
+uint32_t fila_inserir_lote(FilaCircular *f, const void *elementos, uint32_t quantidade);
+uint32_t fila_remover_lote(FilaCircular *f, void *saida, uint32_t quantidade);
+uint32_t fila_ocupacao(const FilaCircular *f);
+bool fila_vazia(const FilaCircular *f);
 
 #endif
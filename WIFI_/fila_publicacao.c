@@ -0,0 +1,220 @@
+/**
+ * @file fila_publicacao.c
+ * @brief Implementação da fila de publicações MQTT com janela em voo e retransmissão.
+ */
+
+#include "fila_publicacao.h"
+#include "nucleo_rede.h"
+#include <string.h>
+
+static PublicacaoMQTT publicacoes[MQTT_FILA_PUB_TAM];
+static uint32_t proxima_ordem = 0;
+static uint32_t em_voo = 0;
+static mqtt_client_t *cliente_atual = NULL;
+static ResultadoPublicacaoCb notificar_resultado = NULL;
+static bool retentativa_agendada = false;
+
+static EstatisticasPublicacao est;
+static uint64_t soma_latencia_us = 0;
+static HistogramaHdr *histograma_latencias = NULL;
+
+/**
+ * @brief Inicializa a fila.
+ *
+ * @param notificar callback opcional chamado com o tipo e o desfecho de cada publicação
+ *                  (ex.: aviso ao núcleo 0 para feedback visual do PING)
+ */
+void fila_publicacao_inicializar(ResultadoPublicacaoCb notificar) {
+    memset(publicacoes, 0, sizeof(publicacoes));
+    memset(&est, 0, sizeof(est));
+    soma_latencia_us = 0;
+    em_voo = 0;
+    notificar_resultado = notificar;
+    controle_taxa_inicializar();
+}
+
+bool fila_publicacao_enfileirar(const char *topico, const void *dados, uint16_t tamanho,
+                                uint8_t qos, uint8_t retain, PrioridadePublicacao prioridade,
+                                TipoPublicacao tipo) {
+    if (tamanho > MQTT_TAM_PAYLOAD || strlen(topico) >= MQTT_TAM_TOPICO) {
+        est.recusadas++;
+        return false;
+    }
+
+    for (int i = 0; i < MQTT_FILA_PUB_TAM; i++) {
+        PublicacaoMQTT *p = &publicacoes[i];
+        if (p->estado != PUB_LIVRE) {
+            continue;
+        }
+        strcpy(p->topico, topico);
+        memcpy(p->dados, dados, tamanho);
+        p->tamanho = tamanho;
+        p->qos = qos;
+        p->retain = retain;
+        p->prioridade = prioridade;
+        p->tipo = tipo;
+        p->tentativas = 0;
+        p->ordem = proxima_ordem++;
+        p->instante_enfileirado_us = time_us_64();
+        p->estado = PUB_PENDENTE;
+        est.profundidade++;
+        return true;
+    }
+
+    est.recusadas++;
+    return false;
+}
+
+// Alarme de nova tentativa (ERR_MEM ou limite de taxa): acorda o supervisor para bombear de novo
+static int64_t retentativa_cb(alarm_id_t id, void *user_data) {
+    retentativa_agendada = false;
+    nucleo_rede_sinalizar();
+    return 0;
+}
+
+static void agendar_retentativa(uint32_t atraso_us) {
+    if (!retentativa_agendada) {
+        retentativa_agendada = true;
+        add_alarm_in_us(atraso_us, retentativa_cb, NULL, true);
+    }
+}
+
+// PING sem confirmação: sai da fila e o desfecho é relatado (ele não é retransmitido)
+static void abandonar_ping(PublicacaoMQTT *p, err_t motivo) {
+    p->estado = PUB_LIVRE;
+    est.profundidade--;
+    est.pings_abandonados++;
+    if (notificar_resultado) {
+        notificar_resultado(PUB_TIPO_PING, motivo);
+    }
+}
+
+// Callback da lwIP: PUBACK recebido (QoS 1), envio concluído (QoS 0) ou timeout
+static void publicacao_concluida_cb(void *arg, err_t result) {
+    PublicacaoMQTT *p = (PublicacaoMQTT *)arg;
+
+    if (p->estado == PUB_EM_VOO) {
+        em_voo--;
+        if (result == ERR_OK) {
+            uint32_t latencia = (uint32_t)(time_us_64() - p->instante_envio_us);
+            soma_latencia_us += latencia;
+            est.confirmadas++;
+            est.latencia_ack_media_us = (uint32_t)(soma_latencia_us / est.confirmadas);
+            if (latencia > est.latencia_ack_max_us) {
+                est.latencia_ack_max_us = latencia;
+            }
+            if (histograma_latencias) {
+                hdr_registrar(histograma_latencias, (uint32_t)(time_us_64() - p->instante_enfileirado_us));
+            }
+            p->estado = PUB_LIVRE;
+            est.profundidade--;
+            if (notificar_resultado) {
+                notificar_resultado(p->tipo, ERR_OK);
+            }
+        } else if (p->tipo == PUB_TIPO_PING) {
+            controle_taxa_congestionado();
+            abandonar_ping(p, result);
+        } else {
+            // Sem confirmação: volta para a fila e será retransmitida
+            p->estado = PUB_PENDENTE;
+            est.retransmissoes++;
+            controle_taxa_congestionado();
+        }
+    }
+
+    // Abriu espaço na janela: envia as próximas
+    if (cliente_atual) {
+        fila_publicacao_bombear(cliente_atual);
+    }
+}
+
+// Próxima publicação pendente: alta prioridade primeiro, depois em ordem de chegada
+static PublicacaoMQTT *proxima_pendente(void) {
+    PublicacaoMQTT *escolhida = NULL;
+    for (int i = 0; i < MQTT_FILA_PUB_TAM; i++) {
+        PublicacaoMQTT *p = &publicacoes[i];
+        if (p->estado != PUB_PENDENTE) {
+            continue;
+        }
+        if (!escolhida || p->prioridade < escolhida->prioridade ||
+            (p->prioridade == escolhida->prioridade && (int32_t)(p->ordem - escolhida->ordem) < 0)) {
+            escolhida = p;
+        }
+    }
+    return escolhida;
+}
+
+// Tamanho do PUBLISH no anel de saída: cabeçalho fixo, tópico, id de pacote e payload
+static uint32_t tamanho_codificado(const PublicacaoMQTT *p) {
+    uint32_t restante = 2 + strlen(p->topico) + (p->qos ? 2 : 0) + p->tamanho;
+    return 1 + (restante < 128 ? 1 : 2) + restante;
+}
+
+/**
+ * @brief Envia publicações pendentes enquanto houver espaço na janela em voo.
+ */
+void fila_publicacao_bombear(mqtt_client_t *client) {
+    cliente_atual = client;
+    if (!client || !mqtt_client_is_connected(client)) {
+        return;
+    }
+
+    PublicacaoMQTT *p;
+    while (em_voo < MQTT_JANELA_EM_VOO && (p = proxima_pendente()) != NULL) {
+        uint32_t espera_us = controle_taxa_permitir(client, tamanho_codificado(p), p->prioridade);
+        if (espera_us) {
+            // Limite de taxa ou buffers da lwIP quase cheios: adia em vez de arriscar ERR_MEM
+            agendar_retentativa(espera_us);
+            break;
+        }
+
+        err_t err = mqtt_publish(client, p->topico, p->dados, p->tamanho,
+                                 p->qos, p->retain, publicacao_concluida_cb, p);
+        if (err == ERR_MEM) {
+            // Sem slot de requisição (ou anel cheio apesar da verificação): tenta mais tarde
+            est.erros_mem++;
+            controle_taxa_congestionado();
+            agendar_retentativa(MQTT_RETENTATIVA_MEM_MS * 1000);
+            break;
+        }
+        if (err != ERR_OK) {
+            printf("Erro ao tentar publicar: %d\n", err);
+            break;
+        }
+
+        controle_taxa_consumir();
+        p->estado = PUB_EM_VOO;
+        p->tentativas++;
+        p->instante_envio_us = time_us_64();
+        em_voo++;
+    }
+
+    est.em_voo = em_voo;
+}
+
+/**
+ * @brief Devolve à fila as publicações em voo (conexão perdida: a lwIP descarta as requisições).
+ *
+ * Os PINGs, em voo ou ainda pendentes, são abandonados: após a reconexão o RTT medido
+ * incluiria o tempo sem conexão.
+ */
+void fila_publicacao_reenfileirar_em_voo(void) {
+    for (int i = 0; i < MQTT_FILA_PUB_TAM; i++) {
+        if (publicacoes[i].estado != PUB_LIVRE && publicacoes[i].tipo == PUB_TIPO_PING) {
+            abandonar_ping(&publicacoes[i], ERR_CONN);
+        } else if (publicacoes[i].estado == PUB_EM_VOO) {
+            publicacoes[i].estado = PUB_PENDENTE;
+            est.retransmissoes++;
+        }
+    }
+    em_voo = 0;
+    est.em_voo = 0;
+}
+
+void fila_publicacao_estatisticas(EstatisticasPublicacao *saida) {
+    *saida = est;
+}
+
+void fila_publicacao_medir_latencias(HistogramaHdr *h) {
+    histograma_latencias = h;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file fila_publicacao.h
+ * @brief Fila limitada de publicações MQTT com suporte a QoS 1, janela em voo e retransmissão.
+ *
+ * As mensagens são copiadas para posições fixas e enviadas em ordem, respeitando no
+ * máximo `MQTT_JANELA_EM_VOO` publicações aguardando confirmação. Uma publicação sai
+ * da fila apenas quando a lwIP confirma (PUBACK para QoS 1, envio para QoS 0).
+ *
+ * - Cada envio passa antes pelo controle de taxa (`controle_taxa.h`); publicações de
+ *   alta prioridade saem antes das de baixa prioridade;
+ * - `ERR_MEM` em `mqtt_publish()` mantém a mensagem pendente e agenda nova tentativa;
+ * - `ERR_TIMEOUT` no callback (PUBACK não recebido) devolve a mensagem à fila;
+ * - Ao perder a conexão, as mensagens em voo voltam a pendentes e são reenviadas
+ *   após a reconexão;
+ * - PINGs (`PUB_TIPO_PING`) não são retransmitidos: um reenvio tardio só distorceria o
+ *   RTT. No timeout ou na queda da conexão, são descartados e relatados como falha.
+ *
+ * O callback de resultado recebe o tipo da publicação e só é chamado no desfecho
+ * final: confirmação, ou PING abandonado.
+ *
+ * Todas as funções devem ser chamadas dentro de `cyw43_arch_lwip_begin/end` (ou em
+ * callbacks da lwIP), pois a fila é compartilhada com o contexto da pilha.
+ */
+
+#ifndef FILA_PUBLICACAO_H
+#define FILA_PUBLICACAO_H
+
+#include "configura_geral.h"
+#include "lwip/apps/mqtt.h"
+#include "histograma_hdr.h"
+#include "controle_taxa.h"
+
+typedef enum {
+    PUB_LIVRE = 0,
+    PUB_PENDENTE,
+    PUB_EM_VOO,
+} EstadoPublicacao;
+
+typedef enum {
+    PUB_TIPO_DADOS = 0,           // Telemetria e estado: retransmitidos até a confirmação
+    PUB_TIPO_PING,                // Medição de RTT: descartado em vez de retransmitido
+} TipoPublicacao;
+
+// Desfecho de uma publicação: ERR_OK, ou o erro que fez um PING ser abandonado
+typedef void (*ResultadoPublicacaoCb)(TipoPublicacao tipo, err_t resultado);
+
+typedef struct {
+    EstadoPublicacao estado;
+    TipoPublicacao tipo;
+    uint32_t ordem;
+    char topico[MQTT_TAM_TOPICO];
+    uint8_t dados[MQTT_TAM_PAYLOAD];
+    uint16_t tamanho;
+    uint8_t qos;
+    uint8_t retain;
+    uint8_t tentativas;
+    PrioridadePublicacao prioridade;
+    uint64_t instante_envio_us;
+    uint64_t instante_enfileirado_us;
+} PublicacaoMQTT;
+
+typedef struct {
+    uint32_t profundidade;        // Pendentes + em voo
+    uint32_t em_voo;
+    uint32_t confirmadas;
+    uint32_t retransmissoes;      // Reenvios após timeout ou reconexão
+    uint32_t erros_mem;           // ERR_MEM devolvidos por mqtt_publish()
+    uint32_t recusadas;           // Publicações recusadas por fila cheia
+    uint32_t pings_abandonados;   // PINGs sem confirmação (timeout ou queda), não reenviados
+    uint32_t latencia_ack_media_us;
+    uint32_t latencia_ack_max_us;
+} EstatisticasPublicacao;
+
+void fila_publicacao_inicializar(ResultadoPublicacaoCb notificar);
+bool fila_publicacao_enfileirar(const char *topico, const void *dados, uint16_t tamanho,
+                                uint8_t qos, uint8_t retain, PrioridadePublicacao prioridade,
+                                TipoPublicacao tipo);
+void fila_publicacao_bombear(mqtt_client_t *client);
+void fila_publicacao_reenfileirar_em_voo(void);
+void fila_publicacao_estatisticas(EstatisticasPublicacao *est);
+
+// Registra em `h` a latência fila→confirmação de cada publicação (NULL desliga)
+void fila_publicacao_medir_latencias(HistogramaHdr *h);
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file histograma_hdr.c
+ * @brief Implementação do histograma log-linear.
+ */
+
+#include "histograma_hdr.h"
+#include <string.h>
+
+#define HDR_LIMITE (1u << (HDR_EXPOENTE_MAX + 1))
+
+void hdr_zerar(HistogramaHdr *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+static uint32_t indice_faixa(uint32_t valor) {
+    if (valor >= HDR_LIMITE) {
+        return HDR_N_FAIXAS - 1;   // Faixa de saturação, separada da última faixa regular
+    }
+    if (valor < HDR_SUB) {
+        return valor;
+    }
+    uint32_t expoente = 31 - __builtin_clz(valor);
+    uint32_t sub = (valor >> (expoente - HDR_BITS_SUB)) & (HDR_SUB - 1);
+    return (expoente - HDR_BITS_SUB + 1) * HDR_SUB + sub;
+}
+
+// Ponto médio da faixa
+static uint32_t valor_faixa(uint32_t indice) {
+    if (indice < HDR_SUB) {
+        return indice;
+    }
+    uint32_t expoente = indice / HDR_SUB + HDR_BITS_SUB - 1;
+    uint32_t sub = indice % HDR_SUB;
+    uint32_t largura = 1u << (expoente - HDR_BITS_SUB);
+    return (HDR_SUB + sub) * largura + largura / 2;
+}
+
+void hdr_registrar(HistogramaHdr *h, uint32_t valor) {
+    h->contagens[indice_faixa(valor)]++;
+    h->total++;
+    if (valor > h->maximo) {
+        h->maximo = valor;
+    }
+}
+
+uint32_t hdr_percentil(const HistogramaHdr *h, uint32_t permil) {
+    if (h->total == 0) {
+        return 0;
+    }
+    uint32_t alvo = (uint32_t)(((uint64_t)h->total * permil + 999) / 1000);
+    if (alvo == 0) {
+        alvo = 1;
+    }
+
+    uint32_t acumulado = 0;
+    for (uint32_t i = 0; i < HDR_N_FAIXAS; i++) {
+        acumulado += h->contagens[i];
+        if (acumulado >= alvo) {
+            if (i == HDR_N_FAIXAS - 1) {
+                return h->maximo;  // Faixa de saturação
+            }
+            uint32_t v = valor_faixa(i);
+            return v < h->maximo ? v : h->maximo;
+        }
+    }
+    return h->maximo;
+}
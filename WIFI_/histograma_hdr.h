@@ -0,0 +1,33 @@
+/**
+ * @file histograma_hdr.h
+ * @brief Histograma log-linear (estilo HDR) de latências em microssegundos.
+ *
+ * Cada potência de 2 é dividida em `HDR_SUB` faixas lineares, o que mantém o erro
+ * relativo abaixo de 1/HDR_SUB (6,25%) em toda a escala, de 1 us a ~33 s, com
+ * memória fixa e registro em O(1) (um `clz` e um deslocamento).
+ */
+
+#ifndef HISTOGRAMA_HDR_H
+#define HISTOGRAMA_HDR_H
+
+#include <stdint.h>
+
+#define HDR_BITS_SUB      4
+#define HDR_SUB           (1u << HDR_BITS_SUB)
+#define HDR_EXPOENTE_MAX  24    // Maior expoente coberto: valores < 2^25 us
+// Faixas regulares mais uma de saturação (a última), para valores >= 2^25 us
+#define HDR_N_FAIXAS      ((HDR_EXPOENTE_MAX - HDR_BITS_SUB + 2) * HDR_SUB + 1)
+
+typedef struct {
+    uint32_t contagens[HDR_N_FAIXAS];
+    uint32_t total;
+    uint32_t maximo;
+} HistogramaHdr;
+
+void hdr_zerar(HistogramaHdr *h);
+void hdr_registrar(HistogramaHdr *h, uint32_t valor);
+
+// Valor representativo do percentil (em milésimos: 500 = p50, 990 = p99)
+uint32_t hdr_percentil(const HistogramaHdr *h, uint32_t permil);
+
+#endif
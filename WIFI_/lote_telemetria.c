@@ -0,0 +1,153 @@
+/**
+ * @file lote_telemetria.c
+ * @brief Implementação do agrupamento de telemetria por tamanho ou prazo.
+ */
+
+#include "lote_telemetria.h"
+#include "mqtt_lwip.h"
+#include "eventos.h"
+#include <string.h>
+
+#define LOTE_CABECALHO 2
+
+static uint8_t buffer_lote[MQTT_LOTE_TAM];
+static uint16_t ocupado = LOTE_CABECALHO;
+static uint8_t n_registros = 0;
+static const char *topico_lote = NULL;
+static absolute_time_t prazo_lote;
+static alarm_id_t alarme_lote = 0;
+static EstatisticasLote est;
+
+void lote_inicializar(const char *topico) {
+    topico_lote = topico;
+    ocupado = LOTE_CABECALHO;
+    n_registros = 0;
+    memset(&est, 0, sizeof(est));
+}
+
+bool lote_vazio(void) {
+    return n_registros == 0;
+}
+
+static int64_t alarme_lote_cb(alarm_id_t id, void *user_data) {
+    alarme_lote = 0;
+    eventos_sinalizar(EVT_MQTT);
+    return 0;
+}
+
+/**
+ * @brief Envia o lote atual (se houver registros) como um único PUBLISH.
+ *
+ * Chamada ao atingir o limiar, ao vencer o prazo e quando a conexão cai
+ * (a fila de publicação guarda o lote até a reconexão).
+ */
+void lote_descarregar(void) {
+    if (n_registros == 0) {
+        return;
+    }
+
+    if (alarme_lote) {
+        cancel_alarm(alarme_lote);
+        alarme_lote = 0;
+    }
+
+    buffer_lote[0] = LOTE_VERSAO;
+    buffer_lote[1] = n_registros;
+
+    if (publicar_mqtt(topico_lote, buffer_lote, ocupado, MQTT_QOS_PADRAO, 0, PRIORIDADE_BAIXA)) {
+        est.lotes++;
+        est.bytes_payload += ocupado;
+        // Cada registro isolado teria o próprio cabeçalho fixo, tópico e id de pacote
+        est.bytes_economizados += (n_registros - 1) * (2 + 2 + strlen(topico_lote) + 2);
+    }
+
+    ocupado = LOTE_CABECALHO;
+    n_registros = 0;
+}
+
+// Garante espaço para um registro de até `tamanho` bytes, enviando o lote atual se preciso
+static bool preparar_registro(uint8_t tamanho) {
+    if (!topico_lote || LOTE_CABECALHO + 1 + tamanho > MQTT_LOTE_TAM) {
+        return false;
+    }
+
+    if (ocupado + 1 + tamanho > MQTT_LOTE_TAM || n_registros == UINT8_MAX) {
+        lote_descarregar();
+    }
+    return true;
+}
+
+// Fecha o registro já escrito após o byte de tamanho em `buffer_lote[ocupado]`
+static void confirmar_registro(uint8_t tamanho) {
+    if (n_registros == 0) {
+        prazo_lote = make_timeout_time_ms(MQTT_LOTE_PRAZO_MS);
+        alarme_lote = add_alarm_at(prazo_lote, alarme_lote_cb, NULL, true);
+    }
+
+    buffer_lote[ocupado] = tamanho;
+    ocupado += 1 + tamanho;
+    n_registros++;
+    est.registros++;
+
+    if (ocupado >= MQTT_LOTE_LIMIAR) {
+        lote_descarregar();
+    }
+}
+
+/**
+ * @brief Acrescenta um registro ao lote.
+ *
+ * Se o registro não couber, o lote atual é enviado antes. Atingido o limiar,
+ * o lote é enviado imediatamente.
+ */
+bool lote_adicionar(const void *dados, uint8_t tamanho) {
+    if (!preparar_registro(tamanho)) {
+        return false;
+    }
+    memcpy(&buffer_lote[ocupado + 1], dados, tamanho);
+    confirmar_registro(tamanho);
+    return true;
+}
+
+/**
+ * @brief Abre um registro para ser codificado diretamente no buffer do lote.
+ *
+ * Evita a cópia intermediária: o escritor CBOR aponta para a posição do próximo
+ * registro. Deve ser seguida por `lote_concluir_registro()` antes de qualquer
+ * outra chamada a este módulo.
+ *
+ * @param tamanho_max maior tamanho que o registro codificado pode ter
+ */
+bool lote_iniciar_registro(CborEscritor *w, uint8_t tamanho_max) {
+    if (!preparar_registro(tamanho_max)) {
+        return false;
+    }
+    cbor_iniciar(w, &buffer_lote[ocupado + 1], tamanho_max);
+    return true;
+}
+
+/**
+ * @brief Fecha o registro aberto por `lote_iniciar_registro()`.
+ *
+ * @return false se o registro estourou `tamanho_max` (é descartado)
+ */
+bool lote_concluir_registro(const CborEscritor *w) {
+    if (!cbor_ok(w)) {
+        return false;
+    }
+    confirmar_registro((uint8_t)cbor_tamanho(w));
+    return true;
+}
+
+/**
+ * @brief Envia o lote se o prazo venceu (chamada pelo laço principal em `EVT_MQTT`).
+ */
+void lote_processar(void) {
+    if (n_registros > 0 && time_reached(prazo_lote)) {
+        lote_descarregar();
+    }
+}
+
+void lote_estatisticas(EstatisticasLote *saida) {
+    *saida = est;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file lote_telemetria.h
+ * @brief Agrupamento de amostras de telemetria em um único PUBLISH.
+ *
+ * Em vez de um pacote MQTT por amostra (cada um com cabeçalho fixo, tópico e
+ * segmento TCP próprios), os registros são acumulados em um buffer e enviados
+ * juntos quando o tamanho atinge `MQTT_LOTE_LIMIAR` ou quando o prazo
+ * `MQTT_LOTE_PRAZO_MS`, contado a partir do primeiro registro, expira.
+ *
+ * Formato do payload (enquadramento):
+ *
+ * | byte 0  | byte 1       | registros...                         |
+ * |---------|--------------|--------------------------------------|
+ * | versão  | n_registros  | [tamanho (1 byte)][dados] × n        |
+ *
+ * Os registros de telemetria do firmware são mapas CBOR (`cbor_mini.h`) codificados
+ * diretamente no buffer do lote por `lote_iniciar_registro()`/`lote_concluir_registro()`.
+ *
+ * Uso exclusivo do núcleo 0 (não é chamado a partir de callbacks da lwIP).
+ */
+
+#ifndef LOTE_TELEMETRIA_H
+#define LOTE_TELEMETRIA_H
+
+#include "configura_geral.h"
+#include "cbor_mini.h"
+
+#define LOTE_VERSAO 1
+
+typedef struct {
+    uint32_t registros;          // Amostras aceitas
+    uint32_t lotes;              // PUBLISH efetivamente gerados
+    uint32_t bytes_payload;      // Bytes de payload enviados em lotes
+    uint32_t bytes_economizados; // Cabeçalhos MQTT evitados (estimativa)
+} EstatisticasLote;
+
+void lote_inicializar(const char *topico);
+bool lote_adicionar(const void *dados, uint8_t tamanho);
+bool lote_iniciar_registro(CborEscritor *w, uint8_t tamanho_max);
+bool lote_concluir_registro(const CborEscritor *w);
+void lote_processar(void);
+void lote_descarregar(void);
+bool lote_vazio(void);
+void lote_estatisticas(EstatisticasLote *est);
+
+#endif
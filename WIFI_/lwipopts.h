@@ -72,6 +72,16 @@
 #define LWIP_DNS                    1
 #define LWIP_TCP_KEEPALIVE          1
 #define LWIP_NETIF_TX_SINGLE_PBUF   1
+// Cliente MQTT: requisições simultâneas (≥ MQTT_JANELA_EM_VOO) e anel de saída
+#define MQTT_REQ_MAX_IN_FLIGHT      8
+#define MQTT_OUTPUT_RINGBUF_SIZE    512
+#ifdef MQTT_USAR_TLS
+// TLS via altcp (mbedTLS); as alocações do mbedTLS usam o calloc do tls_mqtt.c
+#define LWIP_ALTCP                  1
+#define LWIP_ALTCP_TLS              1
+#define LWIP_ALTCP_TLS_MBEDTLS      1
+#define ALTCP_MBEDTLS_PLATFORM_ALLOC 0
+#endif
 #define DHCP_DOES_ARP_CHECK         0
 #define LWIP_DHCP_DOES_ACD_CHECK    0
 
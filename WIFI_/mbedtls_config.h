@@ -0,0 +1,74 @@
+/**
+ * @file mbedtls_config.h
+ * @brief Configuração do mbedTLS para o cliente MQTT sobre TLS 1.2 (usada com `MQTT_USAR_TLS`).
+ *
+ * Apenas o necessário para um cliente: suítes ECDHE/RSA com AES-GCM/CBC, verificação
+ * X.509, SNI e retomada pelo ID de sessão. Sem tickets: o cliente enviaria um ID aleatório
+ * e `tls_mqtt.c` não saberia se o servidor aceitou a sessão. O certificado do servidor não
+ * é mantido na sessão (`MBEDTLS_SSL_KEEP_PEER_CERTIFICATE` desligado), o que deixa a
+ * sessão guardada para a retomada com poucas centenas de bytes.
+ */
+
+#ifndef MBEDTLS_CONFIG_MQTT_H
+#define MBEDTLS_CONFIG_MQTT_H
+
+// Plataforma: entropia do RP2040 e alocador definido em tempo de execução (tls_mqtt.c)
+#define MBEDTLS_ENTROPY_HARDWARE_ALT
+#define MBEDTLS_NO_PLATFORM_ENTROPY
+#define MBEDTLS_PLATFORM_C
+#define MBEDTLS_PLATFORM_MEMORY
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+#define MBEDTLS_HAVE_TIME
+
+// Protocolo
+#define MBEDTLS_SSL_TLS_C
+#define MBEDTLS_SSL_CLI_C
+#define MBEDTLS_SSL_PROTO_TLS1_2
+#define MBEDTLS_SSL_SERVER_NAME_INDICATION
+#define MBEDTLS_SSL_IN_CONTENT_LEN 16384  // Cadeia de certificados do servidor
+#define MBEDTLS_SSL_OUT_CONTENT_LEN 2048  // Publicações são pequenas
+
+// Troca de chaves e curvas
+#define MBEDTLS_KEY_EXCHANGE_RSA_ENABLED
+#define MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED
+#define MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED
+#define MBEDTLS_ECP_DP_SECP256R1_ENABLED
+#define MBEDTLS_ECP_DP_SECP384R1_ENABLED
+#define MBEDTLS_ECP_DP_CURVE25519_ENABLED
+#define MBEDTLS_ECP_NIST_OPTIM
+#define MBEDTLS_ECDH_C
+#define MBEDTLS_ECDSA_C
+#define MBEDTLS_ECP_C
+#define MBEDTLS_RSA_C
+#define MBEDTLS_PKCS1_V15
+#define MBEDTLS_BIGNUM_C
+
+// Cifras e hashes
+#define MBEDTLS_AES_C
+#define MBEDTLS_AES_FEWER_TABLES
+#define MBEDTLS_GCM_C
+#define MBEDTLS_CIPHER_C
+#define MBEDTLS_CIPHER_MODE_CBC
+#define MBEDTLS_MD_C
+#define MBEDTLS_SHA1_C
+#define MBEDTLS_SHA224_C
+#define MBEDTLS_SHA256_C
+#define MBEDTLS_SHA256_SMALLER
+#define MBEDTLS_SHA384_C
+#define MBEDTLS_SHA512_C
+#define MBEDTLS_CTR_DRBG_C
+#define MBEDTLS_ENTROPY_C
+
+// Certificados
+#define MBEDTLS_X509_USE_C
+#define MBEDTLS_X509_CRT_PARSE_C
+#define MBEDTLS_PK_C
+#define MBEDTLS_PK_PARSE_C
+#define MBEDTLS_OID_C
+#define MBEDTLS_ASN1_PARSE_C
+#define MBEDTLS_ASN1_WRITE_C
+#define MBEDTLS_PEM_PARSE_C
+#define MBEDTLS_BASE64_C
+#define MBEDTLS_ERROR_C
+
+#endif
@@ -7,20 +7,43 @@
  *
  * As principais funcionalidades incluem:
  * - Criação e configuração de um cliente MQTT (`mqtt_client_new`);
- * - Conexão com o broker definido via IP (`MQTT_BROKER_IP`);
+ * - Conexão ao broker mais rápido da lista `MQTT_BROKERS`, com failover (`brokers_mqtt.h`);
+ * - TLS opcional (`MQTT_USAR_TLS`), retomando a sessão anterior nas reconexões (`tls_mqtt.h`);
  * - Callback para conexão bem-sucedida ou falha (`mqtt_connection_cb`);
- * - Publicação de mensagens (`publicar_mensagem_mqtt`);
- * - Callback de confirmação da publicação (`mqtt_pub_cb`);
- * - Uma função vazia `mqtt_loop()` preparada para expansões futuras (ex: manutenção da conexão).
+ * - Publicação de mensagens (`publicar_mensagem_mqtt`) através da fila de saída com QoS 1;
+ * - Callback de desfecho da publicação (`mqtt_pub_cb`), que avisa o núcleo 0 sobre os PINGs;
+ * - `mqtt_loop()`, supervisor que reconecta com backoff exponencial e restaura as assinaturas;
+ * - Registro em flash (`registro_flash.h`) das publicações feitas sem conexão, reenviadas
+ *   em ritmo limitado após a reconexão.
  *
- * Este código é ativado pelo núcleo 0, após a obtenção de um IP válido.
+ * Este código é ativado pelo núcleo 0, após a obtenção de um IP válido. Com
+ * `REDE_NUCLEO_UNICO`, o cliente e a lwIP pertencem ao núcleo 1: as funções públicas
+ * chamadas pelo núcleo 0 apenas submetem comandos (`nucleo_rede.h`), executados por
+ * `mqtt_executar_comando()`, e o supervisor roda em `mqtt_supervisionar()` no núcleo 1.
  */
 
 #include <stdio.h>
 #include "lwip/apps/mqtt.h"     // API MQTT da lwIP
 #include "lwip/ip_addr.h"       // Manipulação de endereços IP
-#include "configura_geral.h"    // Define constantes como TOPICO, MQTT_BROKER_IP, MQTT_BROKER_PORT
+#include "configura_geral.h"    // Define constantes como TOPICO e MQTT_BROKERS
 #include "display_utils.h"      // exibir_status_mqtt() e funções de feedback visual
+#include "protocolo_nucleos.h"  // Envelope de mensagens para o núcleo 0
+#include "eventos.h"            // eventos_sinalizar() para acordar o núcleo 0
+#include "fila_publicacao.h"    // Fila de saída com QoS 1 e janela em voo
+#include "lote_telemetria.h"    // Agrupamento de telemetria em um PUBLISH
+#include "cbor_mini.h"          // Payloads binários compactos
+#include "registro_flash.h"     // Publicações guardadas em flash enquanto offline
+#include "brokers_mqtt.h"       // Seleção do broker e failover
+#include "nucleo_rede.h"        // Fila de comandos para o dono da pilha de rede
+#include "rastro_boot.h"        // Fases MQTT do rastro do boot
+#ifdef MQTT_USAR_TLS
+#include "tls_mqtt.h"           // Transporte TLS com retomada de sessão
+#include "lwip/apps/mqtt_priv.h" // client->conn (contexto TLS da conexão)
+#endif
+#include "mqtt_lwip.h"          // Declarações públicas (TratadorMQTT, assinaturas)
+#include "lwip/opt.h"           // TCP_SND_BUF (relatório de estatísticas)
+#include <string.h>
+#include <stdlib.h>
 
 
 // ========================
@@ -41,6 +64,53 @@ static mqtt_client_t *client;
  */
 static struct mqtt_connect_client_info_t ci;
 
+/**
+ * @brief Broker da conexão atual (ou da tentativa em andamento) e início da tentativa.
+ */
+static int broker_atual = BROKER_NENHUM;
+static uint64_t instante_tentativa_us = 0;
+
+// ========================
+// SUPERVISOR DA CONEXÃO
+// ========================
+
+typedef enum {
+    MQTT_SUP_PARADO = 0,     // Cliente ainda não iniciado
+    MQTT_SUP_CONECTANDO,     // mqtt_client_connect() em andamento
+    MQTT_SUP_CONECTADO,
+    MQTT_SUP_AGUARDANDO,     // Esperando o fim do backoff para nova tentativa
+} EstadoSupervisor;
+
+static volatile EstadoSupervisor estado_sup = MQTT_SUP_PARADO;
+static EstadoSupervisor estado_exibido = MQTT_SUP_PARADO;
+static uint32_t falhas_seguidas = 0;
+static absolute_time_t proxima_tentativa;
+static alarm_id_t alarme_backoff = 0;
+
+// Indisponibilidade: da queda até a próxima conexão aceita
+static uint64_t instante_queda_us = 0;
+static uint32_t reconexoes = 0;
+static uint32_t indisponivel_ultimo_ms = 0;
+static uint32_t indisponivel_max_ms = 0;
+
+// Assinaturas restauradas a cada conexão
+typedef struct {
+    const char *topico;
+    uint8_t qos;
+} AssinaturaMQTT;
+
+static AssinaturaMQTT assinaturas[MQTT_MAX_ASSINATURAS];
+static int n_assinaturas = 0;
+
+// Lado do núcleo 0: iniciar_mqtt_cliente() já submeteu a criação do cliente
+static bool cliente_iniciado = false;
+static ComandoRede cmd;   // Montado pelo núcleo 0 e copiado para a fila de comandos
+
+// Aviso de novo IP que não coube na fila de comandos: resubmetido por mqtt_loop()
+static bool novo_ip_pendente = false;
+static bool novo_ip_mudou = false;
+static alarm_id_t alarme_novo_ip = 0;
+
 // ========================
 // DECLARAÇÕES
 // ========================
@@ -49,16 +119,85 @@ static struct mqtt_connect_client_info_t ci;
  * @brief Declaração antecipada da função de publicação, usada no callback de conexão.
  */
 void publicar_mensagem_mqtt(const char *mensagem);
+bool publicar_mqtt(const char *topico, const void *dados, uint16_t tamanho, uint8_t qos, uint8_t retain,
+                   PrioridadePublicacao prioridade);
+static void tentar_conectar(void);
+static void submeter_novo_ip(void);
+static bool enfileirar_comando(const char *topico, const void *dados, uint16_t tamanho, uint8_t qos,
+                               uint8_t retain, PrioridadePublicacao prioridade, TipoPublicacao tipo);
 
 
 // ========================
 // CALLBACKS DO MQTT
 // ========================
 
+// Callback de SUBSCRIBE: apenas registra falhas
+static void mqtt_sub_cb(void *arg, err_t result) {
+    if (result != ERR_OK) {
+        printf("[MQTT] Falha ao assinar %s: %d\n", (const char *)arg, result);
+    }
+}
+
+// Reenvia todas as assinaturas registradas (a sessão é limpa a cada conexão)
+static void restaurar_assinaturas(mqtt_client_t *client) {
+    for (int i = 0; i < n_assinaturas; i++) {
+        mqtt_subscribe(client, assinaturas[i].topico, assinaturas[i].qos,
+                       mqtt_sub_cb, (void *)assinaturas[i].topico);
+    }
+}
+
+static int64_t alarme_backoff_cb(alarm_id_t id, void *user_data) {
+    alarme_backoff = 0;
+    nucleo_rede_sinalizar();
+    return 0;
+}
+
+// Arma o alarme da próxima tentativa de conexão
+static void agendar_tentativa(uint32_t atraso_ms) {
+    estado_sup = MQTT_SUP_AGUARDANDO;
+    proxima_tentativa = make_timeout_time_ms(atraso_ms);
+    if (alarme_backoff) {
+        cancel_alarm(alarme_backoff);
+    }
+    alarme_backoff = add_alarm_at(proxima_tentativa, alarme_backoff_cb, NULL, true);
+}
+
+/**
+ * @brief Agenda a próxima tentativa com backoff exponencial e jitter.
+ *
+ * O atraso nominal dobra a cada falha (de `MQTT_BACKOFF_BASE_MS` até `MQTT_BACKOFF_MAX_MS`);
+ * o atraso efetivo é sorteado entre metade e o valor nominal, para que vários
+ * dispositivos não reconectem em sincronia. Se houver outro broker utilizável, o
+ * backoff recomeça do valor base (failover rápido).
+ */
+static void agendar_reconexao(void) {
+    // Outro broker disponível: o failover não espera o backoff do que falhou
+    if (brokers_ha_alternativa(broker_atual)) {
+        falhas_seguidas = 0;
+    }
+
+    uint32_t nominal = MQTT_BACKOFF_BASE_MS;
+    for (uint32_t i = 0; i < falhas_seguidas && nominal < MQTT_BACKOFF_MAX_MS; i++) {
+        nominal *= 2;
+    }
+    if (nominal > MQTT_BACKOFF_MAX_MS) {
+        nominal = MQTT_BACKOFF_MAX_MS;
+    }
+    uint32_t atraso = nominal / 2 + (uint32_t)rand() % (nominal / 2 + 1);
+
+    falhas_seguidas++;
+    agendar_tentativa(atraso);
+
+    printf("[MQTT] Nova tentativa em %lu ms (falha %lu)\n",
+           (unsigned long)atraso, (unsigned long)falhas_seguidas);
+}
+
 /**
- * @brief Callback chamado após tentativa de conexão com o broker MQTT.
+ * @brief Callback chamado após tentativa de conexão com o broker MQTT (ou na queda dela).
  *
- * Verifica se a conexão foi aceita. Em caso de sucesso, exibe o status e publica uma mensagem de teste.
+ * Em caso de sucesso, restaura as assinaturas, publica uma mensagem de teste e retoma a
+ * fila de saída. Em caso de falha ou desconexão, devolve as mensagens em voo à fila e
+ * agenda a reconexão. A exibição do estado fica a cargo de `mqtt_loop()` no núcleo 0.
  *
  * @param client ponteiro para o cliente MQTT
  * @param arg argumento opcional (não utilizado aqui)
@@ -67,26 +206,74 @@ void publicar_mensagem_mqtt(const char *mensagem);
 void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection_status_t status)
 {
     if (status == MQTT_CONNECT_ACCEPTED) {
-        exibir_status_mqtt("CONECTADO");
-        publicar_mensagem_mqtt("Pico W online");
+        estado_sup = MQTT_SUP_CONECTADO;
+        falhas_seguidas = 0;
+        rastro_boot_marcar(BOOT_MQTT);
+        uint32_t tempo_conexao_us = (uint32_t)(time_us_64() - instante_tentativa_us);
+        brokers_registrar_sucesso(broker_atual, tempo_conexao_us);
+#ifdef MQTT_USAR_TLS
+        tls_mqtt_conectado(client->conn, broker_atual, tempo_conexao_us);
+#endif
+
+        if (instante_queda_us) {
+            indisponivel_ultimo_ms = (uint32_t)((time_us_64() - instante_queda_us) / 1000);
+            if (indisponivel_ultimo_ms > indisponivel_max_ms) {
+                indisponivel_max_ms = indisponivel_ultimo_ms;
+            }
+            reconexoes++;
+            instante_queda_us = 0;
+            printf("[MQTT] Reconectado em %lu ms\n", (unsigned long)indisponivel_ultimo_ms);
+        }
+
+        restaurar_assinaturas(client);
+        uint8_t online[4];
+        CborEscritor w;
+        cbor_iniciar(&w, online, sizeof(online));
+        cbor_mapa(&w, 1);
+        cbor_u32(&w, TEL_ONLINE);
+        cbor_bool(&w, true);
+        // Contexto da lwIP (núcleo 1): vai direto à fila, sem passar pelo registro em flash
+        fila_publicacao_enfileirar(TOPICO, online, cbor_tamanho(&w), MQTT_QOS_PADRAO, 0, PRIORIDADE_ALTA,
+                                   PUB_TIPO_DADOS);
+        fila_publicacao_bombear(client);
     } else {
-        exibir_status_mqtt("FALHA");
+        if (estado_sup == MQTT_SUP_CONECTADO || !instante_queda_us) {
+            instante_queda_us = time_us_64();
+        }
+        // A lwIP descarta as requisições pendentes: as mensagens em voo voltam para a fila
+        fila_publicacao_reenfileirar_em_voo();
+        brokers_registrar_falha(broker_atual);
+#ifdef MQTT_USAR_TLS
+        tls_mqtt_falhou(broker_atual);
+#endif
+        agendar_reconexao();
     }
+
+    // Acorda o laço principal do núcleo 0 para tratar a mudança de estado
+    eventos_sinalizar(EVT_MQTT);
 }
 
 /**
- * @brief Callback chamado após a tentativa de publicação de uma mensagem.
+ * @brief Callback chamado no desfecho de uma publicação da fila de saída.
  *
- * Confirma se a mensagem foi publicada com sucesso ou informa erro.
+ * Só os PINGs são relatados ao núcleo 0 (feedback visual): a confirmação, ou o erro
+ * que o fez ser abandonado. Telemetria e estado são retransmitidos pela fila e não
+ * geram aviso. A primeira confirmação de qualquer tipo fecha o rastro do boot.
  *
- * @param arg argumento opcional (não utilizado aqui)
+ * @param tipo tipo da publicação concluída
  * @param result código de erro do tipo `err_t`
  */
-void mqtt_pub_cb(void *arg, err_t result) {
-    // Envia de volta ao núcleo 0 o status da publicação de PING
-    uint16_t status = (result == ERR_OK) ? 0 : 1;
-    uint32_t pacote = ((0x9999 << 16) | status);
-    multicore_fifo_push_blocking(pacote);
+static void mqtt_pub_cb(TipoPublicacao tipo, err_t result) {
+    static bool primeira_confirmada = false;
+
+    if (tipo == PUB_TIPO_PING) {
+        protocolo_enviar_pub_ack(result);
+    }
+    if (result == ERR_OK && !primeira_confirmada) {
+        primeira_confirmada = true;
+        rastro_boot_marcar(BOOT_PRIMEIRA_PUB);
+        eventos_sinalizar(EVT_MQTT);   // O núcleo 0 publica o rastro em rastro_boot_relatar()
+    }
 }
 
 
@@ -97,19 +284,35 @@ void mqtt_pub_cb(void *arg, err_t result) {
 /**
  * @brief Inicializa e conecta o cliente MQTT ao broker.
  *
- * A função converte o IP do broker (definido em `configura_geral.h`) e tenta se conectar à porta definida.
- * Em caso de erro, imprime mensagens no terminal e não prossegue.
+ * O registro em flash e o lote de telemetria (núcleo 0) são preparados na primeira chamada;
+ * a criação do cliente e a primeira tentativa de conexão vão para o dono da pilha de rede.
+ * A partir daí, o supervisor mantém a conexão, reconectando com backoff (ou a outro broker)
+ * quando ela cai.
+ *
+ * @return false se a fila de comandos estava cheia; chamar de novo mais tarde.
  */
-void iniciar_mqtt_cliente()
+bool iniciar_mqtt_cliente(void)
 {
-    ip_addr_t broker_ip;
+    static bool modulos_iniciados = false;
+    if (!modulos_iniciados) {
+        registro_flash_inicializar(backend_flash_pico());
+        lote_inicializar(TOPICO_TELEMETRIA);
+        modulos_iniciados = true;
+    }
 
-    // Converte o IP textual para estrutura lwIP
-    if (!ip4addr_aton(MQTT_BROKER_IP, &broker_ip)) {
-        printf("Endereço IP do broker inválido: %s\n", MQTT_BROKER_IP);
-        return;
+    if (!cliente_iniciado) {   // Chamado de novo enquanto as assinaturas não couberem na fila
+        cmd.tipo = CMD_REDE_INICIAR_MQTT;
+        cliente_iniciado = nucleo_rede_submeter(&cmd);
     }
+    return cliente_iniciado;
+}
 
+/**
+ * @brief Cria o cliente e inicia a resolução e a sondagem dos brokers de `MQTT_BROKERS`.
+ *
+ * Executada pelo dono da pilha de rede, com a trava tomada.
+ */
+static void iniciar_rede(void) {
     // Cria o cliente MQTT
     client = mqtt_client_new();
     if (!client) {
@@ -117,55 +320,453 @@ void iniciar_mqtt_cliente()
         return;
     }
 
+    fila_publicacao_inicializar(mqtt_pub_cb);
+    assinaturas_inicializar();
+    mqtt_set_inbound_publish_cb(client, assinaturas_publish_cb, assinaturas_dados_cb, NULL);
+
     // Limpa e configura a estrutura de informações do cliente
     memset(&ci, 0, sizeof(ci));
     ci.client_id = "pico_lwip";  // Nome que o broker verá
+    ci.keep_alive = MQTT_KEEP_ALIVE_S;  // PINGREQ da lwIP detecta broker inalcançável
+
+#ifdef MQTT_USAR_TLS
+    ci.tls_config = tls_mqtt_inicializar();
+#endif
+    brokers_inicializar();
+    tentar_conectar();
+}
+
+// Dispara uma tentativa de conexão (chamar com a trava da lwIP)
+static void tentar_conectar(void) {
+    if (alarme_backoff) {
+        cancel_alarm(alarme_backoff);
+        alarme_backoff = 0;
+    }
+
+    int escolhido = brokers_escolher();
+    if (escolhido == BROKER_NENHUM) {
+        // Nenhum endereço resolvido ainda: aguarda o DNS sem contar como falha
+        agendar_tentativa(BROKER_ESPERA_MS);
+        return;
+    }
+    if (escolhido != broker_atual) {
+        printf("[MQTT] Broker: %s:%u\n", brokers_nome(escolhido), brokers_porta(escolhido));
+        broker_atual = escolhido;
+    }
+
+    estado_sup = MQTT_SUP_CONECTANDO;
+    instante_tentativa_us = time_us_64();
 
     // Conecta ao broker com callback de resultado
-    mqtt_client_connect(client, &broker_ip, MQTT_BROKER_PORT, mqtt_connection_cb, NULL, &ci);
+    err_t err = mqtt_client_connect(client, brokers_endereco(broker_atual), brokers_porta(broker_atual),
+                                    mqtt_connection_cb, NULL, &ci);
+    if (err != ERR_OK && err != ERR_ISCONN) {
+        printf("[MQTT] mqtt_client_connect falhou: %d\n", err);
+        brokers_registrar_falha(broker_atual);
+        if (!instante_queda_us) {
+            instante_queda_us = time_us_64();
+        }
+        agendar_reconexao();
+        return;
+    }
+#ifdef MQTT_USAR_TLS
+    if (err == ERR_OK) {
+        tls_mqtt_preparar(client->conn, broker_atual, brokers_nome(broker_atual));
+    }
+#endif
+}
+
+/**
+ * @brief Registra um filtro a ser assinado agora (se conectado) e a cada reconexão.
+ *
+ * O filtro é compilado na trie de `assinaturas_mqtt.c`; as mensagens que casarem
+ * são entregues a `tratador` no contexto da lwIP. O registro é assíncrono: um filtro
+ * inválido (ou a tabela cheia) é relatado pelo núcleo de rede.
+ *
+ * @param filtro string com duração estática (o ponteiro é guardado)
+ * @return false se o comando não pôde ser submetido.
+ */
+bool mqtt_registrar_assinatura(const char *filtro, uint8_t qos, TratadorMQTT tratador, void *contexto) {
+    cmd.tipo = CMD_REDE_ASSINAR;
+    cmd.qos = qos;
+    cmd.sub.filtro = filtro;
+    cmd.sub.tratador = tratador;
+    cmd.sub.contexto = contexto;
+    return nucleo_rede_submeter(&cmd);
+}
+
+static void assinar(const ComandoRede *cmd) {
+    const char *filtro = cmd->sub.filtro;
+    bool ok = n_assinaturas < MQTT_MAX_ASSINATURAS &&
+              assinaturas_registrar(filtro, cmd->sub.tratador, cmd->sub.contexto);
+    if (!ok) {
+        printf("[MQTT] Filtro inválido ou tabela cheia: %s\n", filtro);
+        return;
+    }
+
+    assinaturas[n_assinaturas].topico = filtro;
+    assinaturas[n_assinaturas].qos = cmd->qos;
+    n_assinaturas++;
+    if (mqtt_client_is_connected(client)) {
+        mqtt_subscribe(client, filtro, cmd->qos, mqtt_sub_cb, (void *)filtro);
+    }
+}
+
+/**
+ * @brief Informa ao supervisor que o núcleo 1 (re)obteve um endereço IP.
+ *
+ * Se o cliente não estiver conectado, cancela o backoff e reconecta imediatamente.
+ * Se estiver conectado mas o endereço mudou, a conexão antiga é encerrada antes.
+ * Com a fila de comandos cheia, o aviso fica pendente e é resubmetido, em vez de deixar
+ * o supervisor esperar o backoff corrente.
+ */
+void mqtt_notificar_novo_ip(bool endereco_mudou) {
+    if (!cliente_iniciado) {
+        return;
+    }
+    novo_ip_mudou = novo_ip_mudou || endereco_mudou;   // Avisos acumulados viram um só
+    submeter_novo_ip();
+}
+
+static int64_t alarme_novo_ip_cb(alarm_id_t id, void *user_data) {
+    alarme_novo_ip = 0;
+    eventos_sinalizar(EVT_MQTT);
+    return 0;
+}
+
+// Com a fila de comandos cheia, tenta de novo em REDE_NOVA_SUBMISSAO_MS (via EVT_MQTT)
+static void submeter_novo_ip(void) {
+    cmd.tipo = CMD_REDE_NOVO_IP;
+    cmd.endereco_mudou = novo_ip_mudou;
+    if (nucleo_rede_submeter(&cmd)) {
+        novo_ip_pendente = false;
+        novo_ip_mudou = false;
+        return;
+    }
+    novo_ip_pendente = true;
+    if (!alarme_novo_ip) {
+        alarme_novo_ip = add_alarm_in_ms(REDE_NOVA_SUBMISSAO_MS, alarme_novo_ip_cb, NULL, true);
+    }
+}
+
+static void tratar_novo_ip(bool endereco_mudou) {
+    bool conectado = mqtt_client_is_connected(client);
+    if (conectado && endereco_mudou) {
+        instante_queda_us = time_us_64();
+        mqtt_disconnect(client);
+        fila_publicacao_reenfileirar_em_voo();
+        conectado = false;
+    }
+    if (!conectado && estado_sup != MQTT_SUP_CONECTANDO) {
+        falhas_seguidas = 0;
+        tentar_conectar();
+    }
+    eventos_sinalizar(EVT_MQTT);
 }
 
 /**
  * @brief Publica uma mensagem no tópico definido.
  *
- * Antes de enviar, verifica se o cliente está conectado.
+ * A mensagem entra na fila de saída (QoS `MQTT_QOS_PADRAO`) e é enviada assim que
+ * houver conexão e espaço na janela em voo; se o cliente estiver desconectado, ela
+ * é guardada no registro em flash e reenviada após a reconexão.
  *
  * @param mensagem texto a ser publicado no tópico MQTT.
  */
 void publicar_mensagem_mqtt(const char *mensagem)
 {
-    if (!client) {
+    publicar_mqtt(TOPICO, mensagem, strlen(mensagem), MQTT_QOS_PADRAO, 0, PRIORIDADE_ALTA);
+}
+
+/**
+ * @brief Enfileira uma publicação com tópico, QoS e retain explícitos.
+ *
+ * Chamar apenas no núcleo 0 (o registro em flash não é compartilhado com a lwIP).
+ *
+ * @return false se nem a fila de saída nem o registro em flash aceitaram a mensagem.
+ */
+bool publicar_mqtt(const char *topico, const void *dados, uint16_t tamanho, uint8_t qos, uint8_t retain,
+                   PrioridadePublicacao prioridade)
+{
+    if (!cliente_iniciado) {
         printf("[MQTT] Cliente NULL\n");
         exibir_status_mqtt("CLIENTE NULL");
-        return;
+        return false;
     }
 
-    if (!mqtt_client_is_connected(client)) {
-        printf("[MQTT] Cliente MQTT não está conectado.\n");
-        exibir_status_mqtt("DESCONECTADO");
-        return;
+    // Enquanto houver mensagens no registro em flash, as novas entram atrás delas
+    bool aceita = false;
+    if (estado_sup == MQTT_SUP_CONECTADO && registro_flash_vazio()) {
+        aceita = mqtt_enfileirar(topico, dados, tamanho, qos, retain, prioridade);
     }
 
-    err_t err = mqtt_publish(client,
-                             TOPICO,
-                             mensagem,
-                             strlen(mensagem),
-                             0,
-                             0,
-                             mqtt_pub_cb,
-                             NULL);
+    // Sem conexão (ou fila cheia): guarda no registro para reenvio após a reconexão
+    if (!aceita) {
+        aceita = registro_flash_anexar(topico, dados, tamanho, qos, retain);
+    }
 
-    if (err != ERR_OK) {
-        printf("Erro ao tentar publicar: %d\n", err);
+    if (!aceita) {
+        printf("[MQTT] Fila de publicação e registro cheios.\n");
         exibir_status_mqtt("PUB FALHOU");
     }
+    return aceita;
+}
+
+/**
+ * @brief Publica um PING de medição de RTT no tópico definido.
+ *
+ * Vai à fila de saída como `PUB_TIPO_PING`: não é retransmitido e o desfecho volta ao
+ * núcleo 0 como `MSG_PUB_ACK`. Sem conexão, o PING é descartado em vez de ir para o
+ * registro em flash: reenviado depois, mediria o tempo offline como RTT e, fora de
+ * ordem, falsearia as contagens de perda. O registro fica para telemetria e estado.
+ *
+ * @return false se o PING não foi aceito (sem conexão ou fila cheia).
+ */
+bool publicar_ping(const void *dados, uint16_t tamanho)
+{
+    if (!cliente_iniciado || estado_sup != MQTT_SUP_CONECTADO) {
+        return false;
+    }
+    return enfileirar_comando(TOPICO, dados, tamanho, MQTT_QOS_PADRAO, 0, PRIORIDADE_ALTA, PUB_TIPO_PING);
+}
+
+/**
+ * @brief Tenta apenas a fila de saída, sem recorrer ao registro em flash.
+ *
+ * Usada no reenvio do registro e no benchmark. Tópico e payload são copiados para o
+ * comando; com `REDE_NUCLEO_UNICO`, a mensagem chega à fila de saída pelo núcleo 1.
+ *
+ * @return false se a fila (de comandos ou de saída) estiver cheia.
+ */
+bool mqtt_enfileirar(const char *topico, const void *dados, uint16_t tamanho, uint8_t qos, uint8_t retain,
+                     PrioridadePublicacao prioridade)
+{
+    return enfileirar_comando(topico, dados, tamanho, qos, retain, prioridade, PUB_TIPO_DADOS);
+}
+
+// Copia a publicação para um comando do dono da pilha de rede
+static bool enfileirar_comando(const char *topico, const void *dados, uint16_t tamanho, uint8_t qos,
+                               uint8_t retain, PrioridadePublicacao prioridade, TipoPublicacao tipo)
+{
+    size_t tam_topico = strlen(topico);
+    if (tam_topico >= MQTT_TAM_TOPICO || tamanho > MQTT_TAM_PAYLOAD) {
+        return false;
+    }
+
+    cmd.tipo = CMD_REDE_PUBLICAR;
+    cmd.qos = qos;
+    cmd.retain = retain;
+    cmd.prioridade = prioridade;
+    cmd.tipo_pub = tipo;
+    cmd.tamanho = tamanho;
+    memcpy(cmd.pub.topico, topico, tam_topico + 1);
+    memcpy(cmd.pub.dados, dados, tamanho);
+    return nucleo_rede_submeter(&cmd);
 }
 
 /**
- * @brief Função reservada para uso futuro (manutenção da conexão MQTT).
+ * @brief Executa um comando submetido pelo núcleo 0 (chamar com a trava da lwIP).
  *
- * Pode ser usada no futuro para reenvio, ping ou reconexão manual.
+ * @return false se a publicação não coube na fila de saída (o comando deve ser repetido).
+ */
+bool mqtt_executar_comando(const ComandoRede *cmd) {
+    if (cmd->tipo == CMD_REDE_INICIAR_MQTT) {
+        iniciar_rede();
+        return true;
+    }
+    if (!client) {
+        return true;   // Criação do cliente falhou: o comando é descartado
+    }
+
+    switch (cmd->tipo) {
+        case CMD_REDE_PUBLICAR: {
+            bool aceita = fila_publicacao_enfileirar(cmd->pub.topico, cmd->pub.dados, cmd->tamanho,
+                                                     cmd->qos, cmd->retain,
+                                                     (PrioridadePublicacao)cmd->prioridade,
+                                                     (TipoPublicacao)cmd->tipo_pub);
+            fila_publicacao_bombear(client);
+            return aceita;
+        }
+        case CMD_REDE_ASSINAR:
+            assinar(cmd);
+            return true;
+        case CMD_REDE_NOVO_IP:
+            tratar_novo_ip(cmd->endereco_mudou);
+            return true;
+        default:
+            return true;
+    }
+}
+
+// Reenvio do registro em flash: baixa prioridade, cede espaço ao tráfego novo
+static bool reenviar_registro(const char *topico, const void *dados, uint16_t tamanho,
+                              uint8_t qos, uint8_t retain) {
+    return mqtt_enfileirar(topico, dados, tamanho, qos, retain, PRIORIDADE_BAIXA);
+}
+
+bool mqtt_esta_conectado(void) {
+    return estado_sup == MQTT_SUP_CONECTADO;
+}
+
+// Texto exibido no OLED para cada estado do supervisor
+static const char *descrever_estado(EstadoSupervisor estado) {
+    switch (estado) {
+        case MQTT_SUP_CONECTANDO: return "CONECTANDO";
+        case MQTT_SUP_CONECTADO:  return "CONECTADO";
+        case MQTT_SUP_AGUARDANDO: return "FALHA";
+        default:                  return "PARADO";
+    }
+}
+
+/**
+ * @brief Supervisor da conexão MQTT (chamar com a trava da lwIP, no dono da pilha de rede).
+ *
+ * - Detecta quedas não reportadas por callback e agenda a reconexão;
+ * - Dispara a nova tentativa quando o backoff expira;
+ * - Reenvia publicações pendentes (após ERR_MEM, timeout de PUBACK ou reconexão).
+ */
+void mqtt_supervisionar(void) {
+    if (!client) {
+        return;
+    }
+
+#if REDE_NUCLEO_UNICO
+    EstadoSupervisor anterior = estado_sup;
+#endif
+    brokers_processar();
+    if (estado_sup == MQTT_SUP_CONECTADO && !mqtt_client_is_connected(client)) {
+        instante_queda_us = time_us_64();
+        fila_publicacao_reenfileirar_em_voo();
+        brokers_registrar_falha(broker_atual);
+        agendar_reconexao();
+    }
+    if (estado_sup == MQTT_SUP_AGUARDANDO && time_reached(proxima_tentativa)) {
+        tentar_conectar();
+    }
+    fila_publicacao_bombear(client);
+
+#if REDE_NUCLEO_UNICO
+    // O núcleo 0 atualiza o OLED e troca entre fila de saída e registro em flash
+    if (estado_sup != anterior) {
+        eventos_sinalizar(EVT_MQTT);
+    }
+#endif
+}
+
+/**
+ * @brief Laço do MQTT no núcleo 0, chamado em `EVT_MQTT`.
+ *
+ * Lote de telemetria, registro em flash e estado exibido no OLED; no arranjo sem
+ * `REDE_NUCLEO_UNICO`, também roda o supervisor da conexão.
  */
 void mqtt_loop() {
-    // Espaço reservado para verificações futuras
+    if (!cliente_iniciado) {
+        return;
+    }
+    if (novo_ip_pendente) {
+        submeter_novo_ip();
+    }
+
+#if !REDE_NUCLEO_UNICO
+    nucleo_rede_travar();
+    mqtt_supervisionar();
+    nucleo_rede_destravar();
+#endif
+    EstadoSupervisor estado = estado_sup;
+
+    // Lote de telemetria: envia ao vencer o prazo ou, sem conexão, entrega ao registro em flash
+    if (estado != MQTT_SUP_CONECTADO) {
+        lote_descarregar();
+        registro_flash_sincronizar_se_antigo();
+    } else {
+        lote_processar();
+        registro_flash_processar(reenviar_registro);
+    }
+
+    if (estado != estado_exibido) {
+        estado_exibido = estado;
+        exibir_status_mqtt(descrever_estado(estado));
+        if (estado == MQTT_SUP_CONECTADO && reconexoes > 0) {
+            printf("[MQTT] Reconectado após %lu ms indisponível (máx %lu ms, %lu reconexões)\n",
+                   (unsigned long)indisponivel_ultimo_ms, (unsigned long)indisponivel_max_ms,
+                   (unsigned long)reconexoes);
+        }
+    }
+}
+
+/**
+ * @brief Imprime profundidade da fila, janela em voo e latência de PUBACK.
+ *
+ * Útil para ajustar `MQTT_JANELA_EM_VOO` frente ao `TCP_SND_BUF` de `lwipopts.h`.
+ */
+void mqtt_imprimir_estatisticas(void) {
+    EstatisticasPublicacao est;
+    EstatisticasTaxa taxa;
+
+    nucleo_rede_travar();
+    fila_publicacao_estatisticas(&est);
+    controle_taxa_estatisticas(&taxa);
+    nucleo_rede_destravar();
+
+    printf("[MQTT] Fila: %lu, em voo: %lu/%u, confirmadas: %lu, retransmissões: %lu, ERR_MEM: %lu, "
+           "recusadas: %lu, PINGs abandonados: %lu\n",
+           (unsigned long)est.profundidade, (unsigned long)est.em_voo, MQTT_JANELA_EM_VOO,
+           (unsigned long)est.confirmadas, (unsigned long)est.retransmissoes,
+           (unsigned long)est.erros_mem, (unsigned long)est.recusadas,
+           (unsigned long)est.pings_abandonados);
+    printf("[MQTT] Latência de ACK: média %lu us, máx %lu us (TCP_SND_BUF = %u)\n",
+           (unsigned long)est.latencia_ack_media_us, (unsigned long)est.latencia_ack_max_us,
+           (unsigned)TCP_SND_BUF);
+    printf("[MQTT] Taxa: %lu msgs/s, limitadas: %lu, baixa prioridade adiadas: %lu, "
+           "anel cheio: %lu, reduções: %lu\n",
+           (unsigned long)taxa.taxa_atual, (unsigned long)taxa.limitadas,
+           (unsigned long)taxa.adiadas_baixa, (unsigned long)taxa.sem_espaco_anel,
+           (unsigned long)taxa.reducoes);
+
+    EstatisticasLote lote;
+    lote_estatisticas(&lote);
+    printf("[MQTT] Telemetria: %lu registros em %lu lotes, %lu bytes, ~%lu bytes de cabeçalho evitados\n",
+           (unsigned long)lote.registros, (unsigned long)lote.lotes,
+           (unsigned long)lote.bytes_payload, (unsigned long)lote.bytes_economizados);
+
+    nucleo_rede_travar();
+    brokers_imprimir();
+#ifdef MQTT_USAR_TLS
+    EstatisticasTls tls;
+    tls_mqtt_estatisticas(&tls);
+#endif
+    nucleo_rede_destravar();
+
+#ifdef MQTT_USAR_TLS
+    printf("[TLS] Completas: %lu (média %lu ms, máx %lu ms, heap pico %lu B); "
+           "retomadas: %lu (média %lu ms, máx %lu ms, heap pico %lu B); recusadas: %lu; "
+           "heap %lu B (pico %lu B)\n",
+           (unsigned long)tls.completas, (unsigned long)(tls.media_completa_us / 1000),
+           (unsigned long)(tls.max_completa_us / 1000), (unsigned long)tls.heap_pico_completa,
+           (unsigned long)tls.retomadas, (unsigned long)(tls.media_retomada_us / 1000),
+           (unsigned long)(tls.max_retomada_us / 1000), (unsigned long)tls.heap_pico_retomada,
+           (unsigned long)tls.recusadas, (unsigned long)tls.heap_atual, (unsigned long)tls.heap_pico);
+#endif
+
+    EstatisticasRegistro reg;
+    registro_flash_estatisticas(&reg);
+    printf("[MQTT] Registro em flash: %lu anexadas, %lu reenviadas, %lu setores gravados "
+           "(%lu pendentes, %lu perdidos), pausa máx %lu us\n",
+           (unsigned long)reg.anexados, (unsigned long)reg.reproduzidos,
+           (unsigned long)reg.setores_gravados, (unsigned long)reg.setores_pendentes,
+           (unsigned long)reg.setores_perdidos, (unsigned long)reg.gravacao_max_us);
+
+    EstatisticasNucleoRede rede;
+    nucleo_rede_estatisticas(&rede);
+    printf("[REDE] Trava: núcleo 0 %lu aquisições (%lu contidas, máx %lu us, total %lu us), "
+           "núcleo 1 %lu (%lu contidas, máx %lu us, total %lu us)\n",
+           (unsigned long)rede.aquisicoes[0], (unsigned long)rede.contidas[0],
+           (unsigned long)rede.espera_max_us[0], (unsigned long)rede.espera_total_us[0],
+           (unsigned long)rede.aquisicoes[1], (unsigned long)rede.contidas[1],
+           (unsigned long)rede.espera_max_us[1], (unsigned long)rede.espera_total_us[1]);
+    printf("[REDE] Comandos: %lu (fila cheia %lu, retidos %lu), latência até a fila de saída "
+           "p50 %lu us, p99 %lu us, máx %lu us\n",
+           (unsigned long)rede.comandos, (unsigned long)rede.fila_cheia, (unsigned long)rede.retidos,
+           (unsigned long)rede.latencia_p50_us, (unsigned long)rede.latencia_p99_us,
+           (unsigned long)rede.latencia_max_us);
 }
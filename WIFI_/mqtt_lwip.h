@@ -1,15 +1,50 @@
 #ifndef MQTT_LWIP_H
 #define MQTT_LWIP_H
 
+#include <stdbool.h>
 #include "lwip/apps/mqtt.h"
+#include "assinaturas_mqtt.h"
+#include "controle_taxa.h"
+#include "nucleo_rede.h"
 
-// Inicializa e conecta o cliente MQTT ao broker definido em configura_geral.h
-void iniciar_mqtt_cliente(void);
+// Inicializa e conecta o cliente MQTT ao broker definido em configura_geral.h;
+// false se o comando não coube na fila do núcleo de rede (tentar de novo)
+bool iniciar_mqtt_cliente(void);
 
 // Publica uma mensagem no tópico definido (TOPICO) em configura_geral.h
 void publicar_mensagem_mqtt(const char *mensagem);
 
-// Loop de manutenção MQTT (reservado para uso futuro)
+// Publica com tópico, QoS, retain e prioridade explícitos (via fila de saída)
+bool publicar_mqtt(const char *topico, const void *dados, uint16_t tamanho, uint8_t qos, uint8_t retain,
+                   PrioridadePublicacao prioridade);
+
+// PING de RTT no tópico TOPICO: descartado sem conexão (nunca vai ao registro em flash)
+// e não retransmitido; o desfecho volta como MSG_PUB_ACK
+bool publicar_ping(const void *dados, uint16_t tamanho);
+
+// Apenas a fila de saída (sem registro em flash); false se cheia
+bool mqtt_enfileirar(const char *topico, const void *dados, uint16_t tamanho, uint8_t qos, uint8_t retain,
+                     PrioridadePublicacao prioridade);
+
+// Conexão com o broker aceita
+bool mqtt_esta_conectado(void);
+
+// Supervisor da conexão: reconexão com backoff e reenvio de publicações pendentes
 void mqtt_loop(void);
 
+// Registra um filtro (com + e #) assinado a cada (re)conexão e o tratador das mensagens
+bool mqtt_registrar_assinatura(const char *filtro, uint8_t qos, TratadorMQTT tratador, void *contexto);
+
+// IP (re)obtido pelo núcleo 1: reconecta imediatamente se necessário
+void mqtt_notificar_novo_ip(bool endereco_mudou);
+
+// Dono da pilha de rede (com a trava): executa um comando do núcleo 0; false para repetir
+bool mqtt_executar_comando(const ComandoRede *cmd);
+
+// Dono da pilha de rede (com a trava): reconexão, failover e bombeamento da fila de saída
+void mqtt_supervisionar(void);
+
+// Imprime estatísticas da fila de publicação
+void mqtt_imprimir_estatisticas(void);
+
 #endif
@@ -0,0 +1,175 @@
+/**
+ * @file nucleo_rede.c
+ * @brief Fila de comandos para o núcleo de rede e medição da trava da lwIP.
+ */
+
+#include "nucleo_rede.h"
+#include "fila_circular.h"
+#include "histograma_hdr.h"
+#include "mqtt_lwip.h"
+#include "eventos.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+#include <string.h>
+
+_Static_assert((REDE_TAM_FILA_COMANDOS & (REDE_TAM_FILA_COMANDOS - 1)) == 0,
+               "REDE_TAM_FILA_COMANDOS deve ser potência de dois");
+
+#define REDE_RETENTATIVA_US 1000   // Fila de saída cheia: nova passada após este atraso
+
+static FilaCircular fila_comandos;
+FILA_DECLARAR_BUFFER(buffer_comandos, ComandoRede, REDE_TAM_FILA_COMANDOS);
+
+static volatile bool supervisao_pendente = false;
+
+// Escritos sob a trava da lwIP
+static EstatisticasNucleoRede est;
+static HistogramaHdr latencias;
+
+// ========================
+// TRAVA DA LWIP
+// ========================
+
+void nucleo_rede_travar(void) {
+    uint64_t inicio = time_us_64();
+    cyw43_arch_lwip_begin();
+    uint32_t espera = (uint32_t)(time_us_64() - inicio);
+
+    uint32_t n = get_core_num();
+    est.aquisicoes[n]++;
+    est.espera_total_us[n] += espera;
+    if (espera > REDE_LIMIAR_CONTENCAO_US) {
+        est.contidas[n]++;
+    }
+    if (espera > est.espera_max_us[n]) {
+        est.espera_max_us[n] = espera;
+    }
+}
+
+void nucleo_rede_destravar(void) {
+    cyw43_arch_lwip_end();
+}
+
+// ========================
+// COMANDOS
+// ========================
+
+void nucleo_rede_inicializar(void) {
+    fila_inicializar(&fila_comandos, buffer_comandos, sizeof(ComandoRede), REDE_TAM_FILA_COMANDOS);
+    hdr_zerar(&latencias);
+}
+
+// Executa um comando com a trava tomada; false se precisar ser repetido depois
+static bool executar(const ComandoRede *cmd) {
+    if (!mqtt_executar_comando(cmd)) {
+        est.retidos++;
+        return false;
+    }
+    uint32_t latencia = (uint32_t)(time_us_64() - cmd->instante_us);
+    hdr_registrar(&latencias, latencia);
+    est.comandos++;
+    return true;
+}
+
+#if REDE_NUCLEO_UNICO
+
+static alarm_pool_t *pool_rede;
+static repeating_timer_t temporizador;
+
+static bool temporizador_cb(repeating_timer_t *t) {
+    nucleo_rede_sinalizar();
+    return true;
+}
+
+static int64_t retentativa_cb(alarm_id_t id, void *user_data) {
+    nucleo_rede_sinalizar();
+    return 0;
+}
+
+void nucleo_rede_iniciar_nucleo1(alarm_pool_t *pool) {
+    pool_rede = pool;
+    alarm_pool_add_repeating_timer_ms(pool, REDE_PERIODO_MS, temporizador_cb, NULL, &temporizador);
+}
+
+bool nucleo_rede_submeter(ComandoRede *cmd) {
+    cmd->instante_us = time_us_64();
+    if (!fila_inserir(&fila_comandos, cmd)) {
+        est.fila_cheia++;   // Único escritor: o núcleo 0
+        return false;
+    }
+    __sev();
+    return true;
+}
+
+void nucleo_rede_sinalizar(void) {
+    supervisao_pendente = true;
+    __sev();
+}
+
+/**
+ * @brief Drena a fila de comandos e roda o supervisor, tudo sob uma única aquisição da trava.
+ *
+ * Um comando que não cabe na fila de saída fica na frente da fila de comandos (a ordem
+ * é preservada) e o núcleo 0 passa a ver a fila cheia, desviando para o registro em flash.
+ */
+void nucleo_rede_processar(void) {
+    if (fila_vazia(&fila_comandos) && !supervisao_pendente) {
+        return;
+    }
+    supervisao_pendente = false;
+
+    static ComandoRede cmd;
+    nucleo_rede_travar();
+    while (fila_espiar(&fila_comandos, &cmd)) {
+        if (!executar(&cmd)) {
+            alarm_pool_add_alarm_in_us(pool_rede, REDE_RETENTATIVA_US, retentativa_cb, NULL, true);
+            break;
+        }
+        fila_remover(&fila_comandos, &cmd);
+    }
+    mqtt_supervisionar();
+    nucleo_rede_destravar();
+}
+
+#else
+
+// Arranjo anterior: o núcleo 0 executa os comandos na hora e supervisiona em EVT_MQTT
+
+void nucleo_rede_iniciar_nucleo1(alarm_pool_t *pool) {
+}
+
+bool nucleo_rede_submeter(ComandoRede *cmd) {
+    cmd->instante_us = time_us_64();
+    nucleo_rede_travar();
+    bool ok = executar(cmd);
+    nucleo_rede_destravar();
+    if (!ok) {
+        est.fila_cheia++;
+    }
+    return ok;
+}
+
+void nucleo_rede_sinalizar(void) {
+    eventos_sinalizar(EVT_MQTT);
+}
+
+void nucleo_rede_processar(void) {
+}
+
+#endif
+
+void nucleo_rede_estatisticas(EstatisticasNucleoRede *e) {
+    nucleo_rede_travar();
+    *e = est;
+    e->latencia_p50_us = hdr_percentil(&latencias, 500);
+    e->latencia_p99_us = hdr_percentil(&latencias, 990);
+    e->latencia_max_us = latencias.maximo;
+    nucleo_rede_destravar();
+}
+
+void nucleo_rede_zerar_estatisticas(void) {
+    nucleo_rede_travar();
+    memset(&est, 0, sizeof(est));
+    hdr_zerar(&latencias);
+    nucleo_rede_destravar();
+}
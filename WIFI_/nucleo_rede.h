@@ -0,0 +1,92 @@
+/**
+ * @file nucleo_rede.h
+ * @brief Núcleo 1 como dono único da pilha de rede: fila de comandos vinda do núcleo 0.
+ *
+ * Com `REDE_NUCLEO_UNICO`, toda chamada à lwIP e ao cliente MQTT acontece no núcleo 1
+ * (o mesmo que executou `cyw43_arch_init()` e atende a IRQ do cyw43). O núcleo 0 não
+ * toma mais a trava da lwIP para publicar: ele copia o comando (publicação, assinatura,
+ * novo IP) para uma fila SPSC sem trava (`fila_circular.h`) e acorda o núcleo 1 com
+ * `__sev()`. Os resultados voltam de forma assíncrona: confirmações pelo anel de
+ * `protocolo_nucleos.h` e mudanças de estado por `EVT_MQTT`.
+ *
+ * Com `REDE_NUCLEO_UNICO` = 0, os comandos são executados na hora pelo núcleo 0, sob a
+ * trava (o arranjo anterior), para comparar as medições:
+ * - Contenção da trava: `nucleo_rede_travar()` mede, por núcleo, quantas aquisições
+ *   esperaram mais que `REDE_LIMIAR_CONTENCAO_US` e o tempo de espera;
+ * - Latência de publicação: da submissão no núcleo 0 até a entrada na fila de saída.
+ */
+
+#ifndef NUCLEO_REDE_H
+#define NUCLEO_REDE_H
+
+#include "configura_geral.h"
+#include "assinaturas_mqtt.h"
+#include "controle_taxa.h"
+
+typedef enum {
+    CMD_REDE_INICIAR_MQTT = 0,
+    CMD_REDE_PUBLICAR,
+    CMD_REDE_ASSINAR,
+    CMD_REDE_NOVO_IP,
+} TipoComandoRede;
+
+typedef struct {
+    uint8_t tipo;                 // TipoComandoRede
+    uint8_t qos;
+    uint8_t retain;
+    uint8_t prioridade;           // PrioridadePublicacao
+    uint8_t tipo_pub;             // TipoPublicacao
+    uint16_t tamanho;
+    uint64_t instante_us;         // Submissão no núcleo 0
+    union {
+        struct {
+            char topico[MQTT_TAM_TOPICO];
+            uint8_t dados[MQTT_TAM_PAYLOAD];
+        } pub;
+        struct {
+            const char *filtro;   // Duração estática
+            TratadorMQTT tratador;
+            void *contexto;
+        } sub;
+        bool endereco_mudou;
+    };
+} ComandoRede;
+
+typedef struct {
+    uint32_t aquisicoes[2];       // Por núcleo
+    uint32_t contidas[2];         // Esperaram mais que REDE_LIMIAR_CONTENCAO_US
+    uint32_t espera_max_us[2];
+    uint64_t espera_total_us[2];
+    uint32_t comandos;
+    uint32_t fila_cheia;          // Submissões recusadas
+    uint32_t retidos;             // Execuções adiadas por fila de saída cheia
+    uint32_t latencia_p50_us;     // Submissão → fila de saída
+    uint32_t latencia_p99_us;
+    uint32_t latencia_max_us;
+} EstatisticasNucleoRede;
+
+// Núcleo 0, antes de lançar o núcleo 1
+void nucleo_rede_inicializar(void);
+
+// Núcleo 1, antes do laço: supervisão periódica no pool de alarmes do núcleo
+void nucleo_rede_iniciar_nucleo1(alarm_pool_t *pool);
+
+// Núcleo 0: entrega o comando ao dono da rede. false se a fila estiver cheia.
+bool nucleo_rede_submeter(ComandoRede *cmd);
+
+// Qualquer contexto: pede uma passada do supervisor MQTT
+void nucleo_rede_sinalizar(void);
+
+// Núcleo 1 (laço principal): executa os comandos e o supervisor pendentes
+void nucleo_rede_processar(void);
+
+// Trava da lwIP com medição de contenção (substitui cyw43_arch_lwip_begin/end)
+void nucleo_rede_travar(void);
+void nucleo_rede_destravar(void);
+
+void nucleo_rede_estatisticas(EstatisticasNucleoRede *e);
+
+// Zera contadores e latências (início de cada caso do benchmark)
+void nucleo_rede_zerar_estatisticas(void);
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file protocolo_nucleos.c
+ * @brief Codificação e decodificação dos envelopes trocados entre os núcleos.
+ *
+ * Substitui o empacotamento manual (status/tentativa em uma palavra, sentinelas
+ * 0xFFFE e 0x9999) por mensagens com tipo, tamanho e sequência, permitindo cargas
+ * de várias palavras (IPv6, timestamps) sem risco de dessincronização.
+ */
+
+#include "protocolo_nucleos.h"
+#include "fila_circular.h"
+#include "eventos.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+uint32_t protocolo_erros_cabecalho = 0;
+uint32_t protocolo_lacunas_seq = 0;
+uint32_t protocolo_descartadas = 0;
+
+// Produtores: núcleo 1 e, sem REDE_NUCLEO_UNICO, o supervisor MQTT no núcleo 0, serializados
+// pela trava de hardware; consumidor: laço do núcleo 0
+static FilaCircular anel;
+FILA_DECLARAR_BUFFER(buffer_anel, uint32_t, PROTOCOLO_TAM_ANEL);
+static spin_lock_t *trava_envio;
+
+static uint8_t seq_envio = 0;
+static uint8_t seq_esperada = 0;
+static bool seq_sincronizada = false;
+
+static inline uint32_t montar_cabecalho(uint8_t tipo, uint8_t n_palavras, uint8_t seq) {
+    return ((uint32_t)(PROTOCOLO_MARCA | PROTOCOLO_VERSAO) << 24) |
+           ((uint32_t)tipo << 16) |
+           ((uint32_t)n_palavras << 8) |
+           seq;
+}
+
+void protocolo_inicializar(void) {
+    fila_inicializar(&anel, buffer_anel, sizeof(uint32_t), PROTOCOLO_TAM_ANEL);
+    trava_envio = spin_lock_init(spin_lock_claim_unused(true));
+}
+
+// Insere o envelope inteiro se houver espaço (chamar com a trava de envio)
+static bool inserir_envelope(const uint32_t *envelope, uint32_t n) {
+    if (PROTOCOLO_TAM_ANEL - fila_ocupacao(&anel) < n) {
+        return false;
+    }
+    fila_inserir_lote(&anel, envelope, n);
+    return true;
+}
+
+/**
+ * @brief Envia um envelope completo pelo anel e avisa o núcleo 0.
+ *
+ * A inserção acontece sob uma trava de hardware (que também desabilita as interrupções),
+ * para que callbacks executados no mesmo núcleo (ex.: lwIP) ou o outro núcleo não
+ * intercalem palavras de outra mensagem. Com o anel cheio, espera com as IRQs habilitadas até `PROTOCOLO_ESPERA_US` e então descarta o
+ * envelope; a sequência avança mesmo assim, e o receptor conta a lacuna.
+ *
+ * @return false se o envelope foi descartado.
+ */
+bool protocolo_enviar(uint8_t tipo, const uint32_t *dados, uint8_t n_palavras) {
+    if (n_palavras > PROTOCOLO_MAX_PALAVRAS) {
+        return false;
+    }
+
+    uint32_t envelope[1 + PROTOCOLO_MAX_PALAVRAS];
+    for (uint8_t i = 0; i < n_palavras; i++) {
+        envelope[1 + i] = dados[i];
+    }
+
+    absolute_time_t limite = make_timeout_time_us(PROTOCOLO_ESPERA_US);
+    bool enviado;
+    uint32_t estado = spin_lock_blocking(trava_envio);
+    // A sequência é tomada a cada tentativa, sob a trava: quem inserir durante a espera
+    // recebe um número menor e entra antes no anel, sem inverter a ordem
+    envelope[0] = montar_cabecalho(tipo, n_palavras, seq_envio);
+    while (!(enviado = inserir_envelope(envelope, 1u + n_palavras)) && !time_reached(limite)) {
+        spin_unlock(trava_envio, estado);
+        eventos_sinalizar(EVT_FIFO);   // O núcleo 0 pode estar dormindo com o anel cheio
+        busy_wait_us_32(10);
+        estado = spin_lock_blocking(trava_envio);
+        envelope[0] = montar_cabecalho(tipo, n_palavras, seq_envio);
+    }
+    seq_envio++;
+    if (!enviado) {
+        protocolo_descartadas++;
+    }
+    spin_unlock(trava_envio, estado);
+
+    if (!enviado) {
+        return false;
+    }
+    eventos_sinalizar(EVT_FIFO);
+    return true;
+}
+
+void protocolo_enviar_status_wifi(uint16_t status, uint16_t tentativa) {
+    uint32_t palavra = ((uint32_t)tentativa << 16) | status;
+    protocolo_enviar(MSG_STATUS_WIFI, &palavra, 1);
+}
+
+void protocolo_enviar_ipv4(uint32_t ip_bin) {
+    protocolo_enviar(MSG_IPV4, &ip_bin, 1);
+}
+
+void protocolo_enviar_rssi(int32_t rssi) {
+    uint32_t palavra = (uint32_t)rssi;
+    protocolo_enviar(MSG_RSSI, &palavra, 1);
+}
+
+void protocolo_enviar_pub_ack(int32_t resultado) {
+    uint32_t palavra = (uint32_t)resultado;
+    protocolo_enviar(MSG_PUB_ACK, &palavra, 1);
+}
+
+void protocolo_enviar_timestamp(uint64_t instante_us) {
+    uint32_t palavras[2] = {(uint32_t)instante_us, (uint32_t)(instante_us >> 32)};
+    protocolo_enviar(MSG_TIMESTAMP, palavras, 2);
+}
+
+/**
+ * @brief Lê uma mensagem do anel, se houver.
+ *
+ * @return true se uma mensagem válida foi decodificada em `msg`; false se o anel
+ *         estava vazio ou se a palavra lida não era um cabeçalho válido (descartada).
+ */
+bool protocolo_receber(MensagemNucleo *msg) {
+    uint32_t cabecalho;
+    if (!fila_remover(&anel, &cabecalho)) {
+        return false;
+    }
+
+    uint8_t marca = cabecalho >> 24;
+    uint8_t n_palavras = (cabecalho >> 8) & 0xFF;
+
+    // O emissor insere o envelope inteiro de uma vez: a carga já está no anel
+    if (marca != (PROTOCOLO_MARCA | PROTOCOLO_VERSAO) || n_palavras > PROTOCOLO_MAX_PALAVRAS ||
+        fila_ocupacao(&anel) < n_palavras) {
+        // Palavra fora de envelope: descarta e aguarda o próximo cabeçalho
+        protocolo_erros_cabecalho++;
+        return false;
+    }
+
+    msg->tipo = (cabecalho >> 16) & 0xFF;
+    msg->n_palavras = n_palavras;
+    msg->seq = cabecalho & 0xFF;
+    fila_remover_lote(&anel, msg->dados, n_palavras);
+
+    if (seq_sincronizada && msg->seq != seq_esperada) {
+        protocolo_lacunas_seq++;
+    }
+    seq_esperada = msg->seq + 1;
+    seq_sincronizada = true;
+
+    return true;
+}
+
+/**
+ * @brief Drena em lote as mensagens disponíveis no anel.
+ *
+ * @param saida vetor de destino
+ * @param max   capacidade do vetor
+ * @return quantidade de mensagens válidas gravadas em `saida`
+ */
+uint32_t protocolo_drenar(MensagemNucleo *saida, uint32_t max) {
+    uint32_t n = 0;
+    while (n < max && !fila_vazia(&anel)) {
+        if (protocolo_receber(&saida[n])) {
+            n++;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file protocolo_nucleos.h
+ * @brief Protocolo versionado de mensagens do núcleo 1 para o núcleo 0 em um anel SPSC.
+ *
+ * Cada mensagem é um envelope formado por uma palavra de cabeçalho seguida de
+ * `n_palavras` palavras de carga útil:
+ *
+ * | bits 31..24          | bits 23..16 | bits 15..8   | bits 7..0  |
+ * |----------------------|-------------|--------------|------------|
+ * | 0xA0 | versão (4 b)  | tipo        | n_palavras   | sequência  |
+ *
+ * Os envelopes vão para um anel de palavras em memória compartilhada (`fila_circular.h`)
+ * e o núcleo 0 é avisado por `EVT_FIFO` (`eventos_sinalizar()`, que executa `__sev()`).
+ * A FIFO do SIO fica só para o SDK: o bloqueio de `flash_safe_execute()` troca palavras
+ * de controle por ela e descartaria palavras de envelope que estivessem na fila.
+ *
+ * O envio de um envelope é atômico em relação às interrupções do núcleo emissor,
+ * de modo que um callback da lwIP não consegue intercalar palavras no meio de
+ * outra mensagem; com o anel cheio, o envelope inteiro é descartado (nunca metade).
+ * O receptor valida o cabeçalho e descarta palavras soltas até reencontrar um
+ * cabeçalho válido.
+ */
+
+#ifndef PROTOCOLO_NUCLEOS_H
+#define PROTOCOLO_NUCLEOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PROTOCOLO_VERSAO        1
+#define PROTOCOLO_MARCA         0xA0
+#define PROTOCOLO_MAX_PALAVRAS  6   // Carga útil máxima de um envelope
+#define PROTOCOLO_TAM_ANEL      64  // Palavras no anel (potência de dois): ~9 envelopes cheios
+#define PROTOCOLO_ESPERA_US     2000 // Espera máxima por espaço no anel antes de descartar
+
+// Tipos de mensagem
+typedef enum {
+    MSG_STATUS_WIFI = 1,   // dados[0] = status | (tentativa << 16)
+    MSG_IPV4        = 2,   // dados[0] = IP (a.b.c.d → a << 24 | ... | d)
+    MSG_IPV6        = 3,   // dados[0..3] = endereço IPv6
+    MSG_RSSI        = 4,   // dados[0] = RSSI em dBm (int32_t)
+    MSG_PUB_ACK     = 5,   // dados[0] = err_t do desfecho de um PING
+    MSG_TIMESTAMP   = 6,   // dados[0..1] = time_us_64() (parte baixa, parte alta)
+} TipoMensagem;
+
+typedef struct {
+    uint8_t tipo;
+    uint8_t n_palavras;
+    uint8_t seq;
+    uint32_t dados[PROTOCOLO_MAX_PALAVRAS];
+} MensagemNucleo;
+
+// Núcleo 0, antes de lançar o núcleo 1
+void protocolo_inicializar(void);
+
+// Codificação (núcleo emissor)
+bool protocolo_enviar(uint8_t tipo, const uint32_t *dados, uint8_t n_palavras);
+void protocolo_enviar_status_wifi(uint16_t status, uint16_t tentativa);
+void protocolo_enviar_ipv4(uint32_t ip_bin);
+void protocolo_enviar_rssi(int32_t rssi);
+void protocolo_enviar_pub_ack(int32_t resultado);
+void protocolo_enviar_timestamp(uint64_t instante_us);
+
+// Decodificação (núcleo receptor)
+bool protocolo_receber(MensagemNucleo *msg);
+uint32_t protocolo_drenar(MensagemNucleo *saida, uint32_t max);
+
+// Acesso aos campos da carga útil
+static inline uint16_t protocolo_status_wifi(const MensagemNucleo *m) { return m->dados[0] & 0xFFFF; }
+static inline uint16_t protocolo_tentativa_wifi(const MensagemNucleo *m) { return m->dados[0] >> 16; }
+static inline uint64_t protocolo_timestamp(const MensagemNucleo *m) {
+    return ((uint64_t)m->dados[1] << 32) | m->dados[0];
+}
+
+// Contadores de diagnóstico do receptor
+extern uint32_t protocolo_erros_cabecalho;
+extern uint32_t protocolo_lacunas_seq;
+extern uint32_t protocolo_descartadas;   // Emissor: envelopes sem espaço no anel
+
+#endif
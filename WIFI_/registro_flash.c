@@ -0,0 +1,283 @@
+/**
+ * @file registro_flash.c
+ * @brief Implementação do registro persistente em anel de setores.
+ */
+
+#include "registro_flash.h"
+#include "eventos.h"
+#include <string.h>
+
+#define REGISTRO_MAGIA          0x31464752u  // "RGF1"
+#define REGISTRO_CABECALHO      12
+#define REGISTRO_OFS_CONSUMIDO  8
+#define REGISTRO_MARCADOR       0xA5
+#define REGISTRO_CAB_ENTRADA    5
+
+static const BackendFlash *backend = NULL;
+
+// Setor em montagem na RAM (mesmo layout da flash)
+static uint8_t setor_ram[REGISTRO_FLASH_TAM_SETOR];
+static uint32_t ocupado_ram = REGISTRO_CABECALHO;
+static absolute_time_t instante_primeiro;
+
+static uint32_t setor_escrita = 0;    // Próximo setor a gravar
+static uint32_t setor_leitura = 0;    // Setor pendente mais antigo
+static uint32_t cursor_leitura = REGISTRO_CABECALHO;
+static uint32_t geracao_proxima = 1;
+static uint32_t n_pendentes = 0;
+
+static absolute_time_t proximo_ciclo;
+static alarm_id_t alarme_ciclo = 0;
+static EstatisticasRegistro est;
+
+// Buffer de leitura de uma entrada da flash
+static char topico_lido[MQTT_TAM_TOPICO];
+static uint8_t dados_lidos[MQTT_TAM_PAYLOAD];
+
+static uint32_t ler_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void escrever_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void limpar_setor_ram(void) {
+    memset(setor_ram, 0xFF, sizeof(setor_ram));
+    ocupado_ram = REGISTRO_CABECALHO;
+}
+
+/**
+ * @brief Varre a região e retoma o anel: setores pendentes de um boot anterior são
+ *        reenviados e a escrita continua após o setor de maior geração.
+ */
+void registro_flash_inicializar(const BackendFlash *b) {
+    backend = b;
+    memset(&est, 0, sizeof(est));
+    limpar_setor_ram();
+    n_pendentes = 0;
+    setor_escrita = 0;
+    cursor_leitura = REGISTRO_CABECALHO;
+
+    if (b->tam_setor != REGISTRO_FLASH_TAM_SETOR || b->tam_pagina != REGISTRO_FLASH_TAM_PAGINA) {
+        printf("[REGISTRO] Geometria de flash não suportada\n");
+        backend = NULL;
+        return;
+    }
+
+    uint32_t maior_geracao = 0, menor_pendente = UINT32_MAX;
+    for (uint32_t s = 0; s < b->n_setores; s++) {
+        uint8_t cab[REGISTRO_CABECALHO];
+        b->ler(b->ctx, s * b->tam_setor, cab, sizeof(cab));
+        if (ler_u32(cab) != REGISTRO_MAGIA) {
+            continue;
+        }
+        uint32_t geracao = ler_u32(&cab[4]);
+        if (geracao >= maior_geracao) {
+            maior_geracao = geracao;
+            setor_escrita = (s + 1) % b->n_setores;
+        }
+        if (ler_u32(&cab[REGISTRO_OFS_CONSUMIDO]) == 0xFFFFFFFFu) {
+            n_pendentes++;
+            if (geracao < menor_pendente) {
+                menor_pendente = geracao;
+                setor_leitura = s;
+            }
+        }
+    }
+    geracao_proxima = maior_geracao + 1;
+    if (!n_pendentes) {
+        setor_leitura = setor_escrita;
+    }
+    est.setores_pendentes = n_pendentes;
+
+    if (n_pendentes) {
+        printf("[REGISTRO] %lu setores pendentes de reenvio\n", (unsigned long)n_pendentes);
+    }
+}
+
+bool registro_flash_vazio(void) {
+    return n_pendentes == 0 && ocupado_ram == REGISTRO_CABECALHO;
+}
+
+// Grava o setor montado em RAM (uma pausa por setor, não por mensagem)
+static void gravar_setor_ram(void) {
+    if (!backend || ocupado_ram == REGISTRO_CABECALHO) {
+        return;
+    }
+
+    if (n_pendentes == backend->n_setores) {
+        // Anel cheio: o setor mais antigo é sobrescrito
+        setor_leitura = (setor_leitura + 1) % backend->n_setores;
+        cursor_leitura = REGISTRO_CABECALHO;
+        n_pendentes--;
+        est.setores_perdidos++;
+    }
+
+    escrever_u32(&setor_ram[0], REGISTRO_MAGIA);
+    escrever_u32(&setor_ram[4], geracao_proxima);
+
+    uint64_t inicio = time_us_64();
+    bool ok = backend->gravar_setor(backend->ctx, setor_escrita, setor_ram);
+    uint32_t duracao = (uint32_t)(time_us_64() - inicio);
+    if (duracao > est.gravacao_max_us) {
+        est.gravacao_max_us = duracao;
+    }
+
+    if (!ok) {
+        printf("[REGISTRO] Falha ao gravar setor %lu\n", (unsigned long)setor_escrita);
+        return;  // Mantém o setor em RAM para nova tentativa
+    }
+
+    setor_escrita = (setor_escrita + 1) % backend->n_setores;
+    geracao_proxima++;
+    n_pendentes++;
+    est.setores_gravados++;
+    est.setores_pendentes = n_pendentes;
+    limpar_setor_ram();
+}
+
+bool registro_flash_anexar(const char *topico, const void *dados, uint16_t tamanho,
+                           uint8_t qos, uint8_t retain) {
+    size_t tam_topico = strlen(topico);
+    uint32_t tam_entrada = REGISTRO_CAB_ENTRADA + tam_topico + tamanho;
+
+    if (!backend || tam_topico >= MQTT_TAM_TOPICO || tamanho > MQTT_TAM_PAYLOAD) {
+        return false;
+    }
+
+    if (ocupado_ram + tam_entrada > REGISTRO_FLASH_TAM_SETOR) {
+        gravar_setor_ram();
+        if (ocupado_ram != REGISTRO_CABECALHO) {
+            return false;  // Gravação falhou e o setor em RAM continua cheio
+        }
+    }
+    if (ocupado_ram == REGISTRO_CABECALHO) {
+        instante_primeiro = get_absolute_time();
+    }
+
+    uint8_t *p = &setor_ram[ocupado_ram];
+    p[0] = REGISTRO_MARCADOR;
+    p[1] = (qos & 0x03) | ((retain & 1) << 2);
+    p[2] = (uint8_t)tam_topico;
+    p[3] = (uint8_t)tamanho;
+    p[4] = (uint8_t)(tamanho >> 8);
+    memcpy(&p[REGISTRO_CAB_ENTRADA], topico, tam_topico);
+    memcpy(&p[REGISTRO_CAB_ENTRADA + tam_topico], dados, tamanho);
+    ocupado_ram += tam_entrada;
+    est.anexados++;
+    return true;
+}
+
+// Marca o setor de leitura como consumido e avança para o próximo pendente
+static void consumir_setor(void) {
+    static uint8_t pagina[REGISTRO_FLASH_TAM_PAGINA];
+
+    memset(pagina, 0xFF, sizeof(pagina));
+    memset(&pagina[REGISTRO_OFS_CONSUMIDO], 0, 4);
+    backend->programar_pagina(backend->ctx, setor_leitura * backend->tam_setor, pagina);
+
+    setor_leitura = (setor_leitura + 1) % backend->n_setores;
+    cursor_leitura = REGISTRO_CABECALHO;
+    n_pendentes--;
+    est.setores_pendentes = n_pendentes;
+}
+
+// Reenvia a próxima entrada da flash; false se a fila de saída não a aceitou
+static bool reproduzir_da_flash(EnviarRegistro enviar) {
+    uint32_t base = setor_leitura * backend->tam_setor;
+    uint8_t cab[REGISTRO_CAB_ENTRADA];
+
+    if (cursor_leitura + REGISTRO_CAB_ENTRADA > backend->tam_setor) {
+        consumir_setor();
+        return true;
+    }
+    backend->ler(backend->ctx, base + cursor_leitura, cab, sizeof(cab));
+    uint8_t tam_topico = cab[2];
+    uint16_t tamanho = cab[3] | (cab[4] << 8);
+    if (cab[0] != REGISTRO_MARCADOR || tam_topico >= MQTT_TAM_TOPICO || tamanho > MQTT_TAM_PAYLOAD ||
+        cursor_leitura + REGISTRO_CAB_ENTRADA + tam_topico + tamanho > backend->tam_setor) {
+        consumir_setor();  // Fim do setor (ou entrada corrompida)
+        return true;
+    }
+
+    backend->ler(backend->ctx, base + cursor_leitura + REGISTRO_CAB_ENTRADA, topico_lido, tam_topico);
+    topico_lido[tam_topico] = '\0';
+    backend->ler(backend->ctx, base + cursor_leitura + REGISTRO_CAB_ENTRADA + tam_topico,
+                 dados_lidos, tamanho);
+
+    if (!enviar(topico_lido, dados_lidos, tamanho, cab[1] & 0x03, (cab[1] >> 2) & 1)) {
+        return false;
+    }
+    cursor_leitura += REGISTRO_CAB_ENTRADA + tam_topico + tamanho;
+    est.reproduzidos++;
+    return true;
+}
+
+// Reenvia a entrada mais antiga do setor em RAM e a remove
+static bool reproduzir_da_ram(EnviarRegistro enviar) {
+    uint8_t *p = &setor_ram[REGISTRO_CABECALHO];
+    uint8_t tam_topico = p[2];
+    uint16_t tamanho = p[3] | (p[4] << 8);
+    uint32_t tam_entrada = REGISTRO_CAB_ENTRADA + tam_topico + tamanho;
+
+    memcpy(topico_lido, &p[REGISTRO_CAB_ENTRADA], tam_topico);
+    topico_lido[tam_topico] = '\0';
+    if (!enviar(topico_lido, &p[REGISTRO_CAB_ENTRADA + tam_topico], tamanho,
+                p[1] & 0x03, (p[1] >> 2) & 1)) {
+        return false;
+    }
+
+    memmove(p, p + tam_entrada, ocupado_ram - REGISTRO_CABECALHO - tam_entrada);
+    ocupado_ram -= tam_entrada;
+    memset(&setor_ram[ocupado_ram], 0xFF, tam_entrada);
+    est.reproduzidos++;
+    return true;
+}
+
+static int64_t alarme_ciclo_cb(alarm_id_t id, void *user_data) {
+    alarme_ciclo = 0;
+    eventos_sinalizar(EVT_MQTT);
+    return 0;
+}
+
+/**
+ * @brief Reenvia até `REGISTRO_FLASH_POR_CICLO` mensagens se o intervalo venceu.
+ *
+ * Primeiro os setores gravados (mais antigos), depois o setor em RAM, preservando
+ * a ordem de publicação. Se ainda restarem mensagens, agenda o próximo ciclo.
+ */
+void registro_flash_processar(EnviarRegistro enviar) {
+    if (!backend || registro_flash_vazio() || !time_reached(proximo_ciclo)) {
+        return;
+    }
+
+    for (int i = 0; i < REGISTRO_FLASH_POR_CICLO && !registro_flash_vazio(); i++) {
+        bool aceito = n_pendentes ? reproduzir_da_flash(enviar) : reproduzir_da_ram(enviar);
+        if (!aceito) {
+            break;  // Fila de saída cheia: tenta no próximo ciclo
+        }
+    }
+
+    if (!registro_flash_vazio()) {
+        proximo_ciclo = make_timeout_time_ms(REGISTRO_FLASH_INTERVALO_MS);
+        if (!alarme_ciclo) {
+            alarme_ciclo = add_alarm_at(proximo_ciclo, alarme_ciclo_cb, NULL, true);
+        }
+    }
+}
+
+void registro_flash_sincronizar_se_antigo(void) {
+    if (ocupado_ram != REGISTRO_CABECALHO &&
+        absolute_time_diff_us(instante_primeiro, get_absolute_time()) >
+            (int64_t)REGISTRO_FLASH_SINCRONIA_MS * 1000) {
+        gravar_setor_ram();
+    }
+}
+
+void registro_flash_estatisticas(EstatisticasRegistro *saida) {
+    *saida = est;
+}
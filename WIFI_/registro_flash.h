@@ -0,0 +1,63 @@
+/**
+ * @file registro_flash.h
+ * @brief Registro persistente (store-and-forward) de publicações feitas sem conexão.
+ *
+ * Enquanto o broker está inalcançável, as publicações são anexadas a um setor
+ * montado em RAM; quando ele enche (ou fica antigo demais), o setor inteiro é
+ * gravado de uma só vez, de modo que cada gravação custa um único apagamento e
+ * uma única pausa do outro núcleo. Os setores da região são usados em rodízio,
+ * distribuindo o desgaste; se todos estiverem pendentes, o mais antigo é sobrescrito.
+ *
+ * Layout de cada setor:
+ *
+ * | 0..3  | 4..7    | 8..11      | registros...                                        |
+ * |-------|---------|------------|-----------------------------------------------------|
+ * | magia | geração | consumido  | [0xA5][qos|retain<<2][tam_tópico][tam_dados LE16]... |
+ *
+ * `consumido` é 0xFFFFFFFF enquanto o setor tem mensagens a reenviar e é
+ * programado com 0 quando todas foram reenviadas. Na inicialização, os setores
+ * pendentes são encontrados pela magia e reenviados em ordem de geração.
+ *
+ * Após a reconexão, as mensagens são reenviadas em ritmo limitado
+ * (`REGISTRO_FLASH_POR_CICLO` a cada `REGISTRO_FLASH_INTERVALO_MS`). Entrega
+ * "pelo menos uma vez": um setor parcialmente reenviado quando a energia cai é
+ * reenviado por inteiro no próximo boot.
+ *
+ * Só telemetria e estado passam por aqui: mensagens sensíveis ao tempo, como o PING
+ * de RTT (`publicar_ping()`), são descartadas sem conexão.
+ *
+ * Uso exclusivo do núcleo 0.
+ */
+
+#ifndef REGISTRO_FLASH_H
+#define REGISTRO_FLASH_H
+
+#include "configura_geral.h"
+#include "backend_flash.h"
+
+typedef bool (*EnviarRegistro)(const char *topico, const void *dados, uint16_t tamanho,
+                               uint8_t qos, uint8_t retain);
+
+typedef struct {
+    uint32_t anexados;
+    uint32_t reproduzidos;
+    uint32_t setores_gravados;
+    uint32_t setores_perdidos;   // Sobrescritos antes de serem reenviados
+    uint32_t setores_pendentes;
+    uint32_t gravacao_max_us;    // Maior pausa causada por uma gravação
+} EstatisticasRegistro;
+
+void registro_flash_inicializar(const BackendFlash *backend);
+bool registro_flash_anexar(const char *topico, const void *dados, uint16_t tamanho,
+                           uint8_t qos, uint8_t retain);
+bool registro_flash_vazio(void);
+
+// Conectado: reenvia um ciclo de mensagens se o intervalo venceu
+void registro_flash_processar(EnviarRegistro enviar);
+
+// Sem conexão: grava o setor em RAM se ele estiver pendente há muito tempo
+void registro_flash_sincronizar_se_antigo(void);
+
+void registro_flash_estatisticas(EstatisticasRegistro *est);
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @file rtt_ping.c
+ * @brief Implementação da medição de RTT, perdas e reordenação do PING.
+ */
+
+#include "rtt_ping.h"
+#include "histograma_hdr.h"
+#include "cbor_mini.h"
+#include "mqtt_lwip.h"
+#include "nucleo_rede.h"
+#include "configura_geral.h"
+#include <string.h>
+
+#define RTT_JANELA_BITS 32   // Sequências recentes lembradas para detectar atraso/duplicata
+
+static HistogramaHdr histograma;
+static uint32_t proxima_seq = 0;        // Escrita só pelo núcleo 0
+
+// Estado do receptor (contexto da lwIP)
+static bool algum_recebido = false;
+static uint32_t maior_seq = 0;
+static uint32_t janela = 0;             // Bit i: eco de (maior_seq - i) já recebido
+static ResumoRtt contadores;
+
+// Remontagem de payloads fragmentados (raro: o PING cabe em um fragmento)
+static uint8_t remontagem[RTT_PING_TAM_PAYLOAD];
+
+static void registrar_sequencia(uint32_t seq) {
+    if (!algum_recebido) {
+        algum_recebido = true;
+        maior_seq = seq;
+        janela = 1;
+        return;
+    }
+
+    int32_t avanco = (int32_t)(seq - maior_seq);
+    if (avanco > 0) {
+        contadores.perdidos += (uint32_t)avanco - 1;
+        janela = (uint32_t)avanco < RTT_JANELA_BITS ? (janela << avanco) | 1 : 1;
+        maior_seq = seq;
+        return;
+    }
+
+    uint32_t atraso = (uint32_t)(-avanco);
+    if (atraso >= RTT_JANELA_BITS) {
+        contadores.fora_ordem++;
+    } else if (janela & (1u << atraso)) {
+        contadores.duplicados++;
+    } else {
+        // Já contado como perdido quando a sequência foi pulada
+        janela |= 1u << atraso;
+        contadores.fora_ordem++;
+        contadores.perdidos--;
+    }
+}
+
+static void tratar_eco(const uint8_t *dados, size_t tamanho) {
+    uint64_t agora = time_us_64();
+    CborLeitor r;
+    CborItem item;
+    int64_t chave, valor;
+    bool tem_seq = false, tem_instante = false;
+    uint32_t seq = 0;
+    uint64_t instante = 0;
+
+    cbor_leitor_iniciar(&r, dados, tamanho);
+    if (!cbor_ler(&r, &item) || item.tipo != CBOR_MAPA) {
+        return;
+    }
+    for (uint64_t i = 0; i < item.u; i++) {
+        if (!cbor_ler_inteiro(&r, &chave) || !cbor_ler_inteiro(&r, &valor)) {
+            return;  // Outras mensagens do tópico (ex.: {TEL_ONLINE: true})
+        }
+        if (chave == TEL_SEQ) {
+            seq = (uint32_t)valor;
+            tem_seq = true;
+        } else if (chave == TEL_INSTANTE_US) {
+            instante = (uint64_t)valor;
+            tem_instante = true;
+        }
+    }
+    if (!tem_seq || !tem_instante || instante > agora) {
+        return;
+    }
+
+    uint64_t rtt = agora - instante;
+    hdr_registrar(&histograma, rtt > UINT32_MAX ? UINT32_MAX : (uint32_t)rtt);
+    contadores.recebidos++;
+    registrar_sequencia(seq);
+}
+
+// Tratador do tópico do PING (contexto da lwIP)
+static void tratar_ping(const FragmentoMQTT *f, void *contexto) {
+    if (f->deslocamento == 0 && f->ultimo) {
+        tratar_eco(f->dados, f->tamanho);  // Caso comum: direto do buffer da lwIP
+        return;
+    }
+    if (f->total > sizeof(remontagem)) {
+        return;
+    }
+    memcpy(&remontagem[f->deslocamento], f->dados, f->tamanho);
+    if (f->ultimo) {
+        tratar_eco(remontagem, f->total);
+    }
+}
+
+bool rtt_ping_inicializar(void) {
+    static bool assinado = false;
+    if (!assinado) {
+        hdr_zerar(&histograma);
+        memset(&contadores, 0, sizeof(contadores));
+        assinado = mqtt_registrar_assinatura(TOPICO, MQTT_QOS_PADRAO, tratar_ping, NULL);
+    }
+    return assinado;
+}
+
+size_t rtt_ping_codificar(uint8_t *buf, size_t cap) {
+    CborEscritor w;
+    cbor_iniciar(&w, buf, cap);
+    cbor_mapa(&w, 2);
+    cbor_u32(&w, TEL_SEQ);
+    cbor_u32(&w, proxima_seq);
+    cbor_u32(&w, TEL_INSTANTE_US);
+    cbor_u64(&w, time_us_64());
+    if (!cbor_ok(&w)) {
+        return 0;
+    }
+    proxima_seq++;
+    return cbor_tamanho(&w);
+}
+
+/**
+ * @brief Desfaz o último `rtt_ping_codificar()` quando o PING não foi aceito.
+ *
+ * Sem isso, a sequência pulada seria contada como perda no próximo eco, embora o
+ * PING nunca tenha saído do dispositivo.
+ */
+void rtt_ping_cancelar(void) {
+    proxima_seq--;
+}
+
+void rtt_ping_resumo(ResumoRtt *resumo) {
+    nucleo_rede_travar();
+    *resumo = contadores;
+    resumo->p50_us = hdr_percentil(&histograma, 500);
+    resumo->p99_us = hdr_percentil(&histograma, 990);
+    resumo->max_us = histograma.maximo;
+    nucleo_rede_destravar();
+    resumo->enviados = proxima_seq;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file rtt_ping.h
+ * @brief Medição do tempo de ida e volta (RTT) do PING através do broker.
+ *
+ * Cada PING leva um número de sequência e o instante de envio (`time_us_64()`) em
+ * CBOR. O dispositivo assina o próprio tópico do PING e, ao receber o eco, registra
+ * o RTT em um histograma HDR e contabiliza perdas, chegadas fora de ordem e
+ * duplicatas pela sequência.
+ *
+ * O eco é tratado no contexto da lwIP (núcleo 1); `rtt_ping_resumo()` lê os
+ * contadores sob a trava da lwIP.
+ */
+
+#ifndef RTT_PING_H
+#define RTT_PING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define RTT_PING_TAM_PAYLOAD 24   // {SEQ: u32, INSTANTE_US: u64} ocupa no máximo 17 bytes
+
+typedef struct {
+    uint32_t enviados;
+    uint32_t recebidos;
+    uint32_t perdidos;       // Sequências puladas ainda não recebidas
+    uint32_t fora_ordem;     // Ecos que chegaram depois de um mais novo
+    uint32_t duplicados;
+    uint32_t p50_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} ResumoRtt;
+
+// Assina o tópico do PING (após iniciar_mqtt_cliente()); false com a fila de comandos cheia
+bool rtt_ping_inicializar(void);
+
+// Codifica o próximo PING em `buf`; retorna o tamanho (0 se não couber)
+size_t rtt_ping_codificar(uint8_t *buf, size_t cap);
+
+// Devolve a sequência do último PING codificado, que não chegou a ser publicado
+void rtt_ping_cancelar(void);
+
+void rtt_ping_resumo(ResumoRtt *resumo);
+
+#endif
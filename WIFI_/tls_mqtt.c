@@ -0,0 +1,182 @@
+/**
+ * @file tls_mqtt.c
+ * @brief Implementação do transporte TLS com cache de sessão e medição do handshake.
+ */
+
+#include "tls_mqtt.h"
+
+#ifdef MQTT_USAR_TLS
+
+#include "mbedtls/platform.h"
+#include "mbedtls/ssl.h"
+#include <stdlib.h>
+#include <string.h>
+
+static struct altcp_tls_config *config_tls = NULL;
+
+// Sessão guardada (uma só: pertence ao último broker que aceitou a conexão)
+static mbedtls_ssl_session sessao;
+static bool sessao_valida = false;
+static int broker_sessao = -1;
+
+// ID da sessão oferecida na tentativa atual; o servidor o devolve se aceitar a retomada
+static unsigned char id_oferecido[32];
+static size_t tam_id_oferecido = 0;
+
+static EstatisticasTls est;
+static uint64_t soma_completa_us = 0;
+static uint64_t soma_retomada_us = 0;
+static uint32_t pico_tentativa = 0;   // Pico de heap desde o início da tentativa atual
+
+// ========================
+// HEAP DO MBEDTLS
+// ========================
+
+// Cabeçalho com o tamanho de cada bloco; 8 bytes preservam o alinhamento
+typedef union {
+    size_t tamanho;
+    uint64_t alinhamento;
+} CabecalhoBloco;
+
+static void *tls_calloc(size_t n, size_t tam) {
+    if (tam && n > (SIZE_MAX - sizeof(CabecalhoBloco)) / tam) {
+        return NULL;
+    }
+    size_t total = n * tam;
+    CabecalhoBloco *bloco = calloc(1, sizeof(CabecalhoBloco) + total);
+    if (!bloco) {
+        return NULL;
+    }
+    bloco->tamanho = total;
+    est.heap_atual += total;
+    if (est.heap_atual > est.heap_pico) {
+        est.heap_pico = est.heap_atual;
+    }
+    if (est.heap_atual > pico_tentativa) {
+        pico_tentativa = est.heap_atual;
+    }
+    return bloco + 1;
+}
+
+static void tls_free(void *p) {
+    if (!p) {
+        return;
+    }
+    CabecalhoBloco *bloco = (CabecalhoBloco *)p - 1;
+    est.heap_atual -= bloco->tamanho;
+    free(bloco);
+}
+
+// ========================
+// SESSÃO E CONFIGURAÇÃO
+// ========================
+
+static void descartar_sessao(void) {
+    if (sessao_valida) {
+        mbedtls_ssl_session_free(&sessao);
+        sessao_valida = false;
+    }
+    broker_sessao = -1;
+}
+
+struct altcp_tls_config *tls_mqtt_inicializar(void) {
+    if (config_tls) {
+        return config_tls;
+    }
+    mbedtls_platform_set_calloc_free(tls_calloc, tls_free);
+
+#ifdef MQTT_TLS_CA_CERT
+    // O mbedTLS exige o '\0' final incluído no tamanho de um certificado PEM
+    static const char ca[] = MQTT_TLS_CA_CERT;
+    config_tls = altcp_tls_create_config_client((const uint8_t *)ca, sizeof(ca));
+#else
+    config_tls = altcp_tls_create_config_client(NULL, 0);
+#endif
+    if (!config_tls) {
+        printf("[TLS] Falha ao criar a configuração\n");
+    }
+    return config_tls;
+}
+
+void tls_mqtt_preparar(struct altcp_pcb *conn, int broker, const char *host) {
+    // SNI e verificação do nome no certificado
+    mbedtls_ssl_set_hostname(altcp_tls_context(conn), host);
+
+    if (broker != broker_sessao) {
+        descartar_sessao();
+    }
+    tam_id_oferecido = 0;
+    if (sessao_valida && mbedtls_ssl_set_session(altcp_tls_context(conn), &sessao) == 0) {
+        tam_id_oferecido = mbedtls_ssl_session_get_id_len(&sessao);
+        memcpy(id_oferecido, mbedtls_ssl_session_get_id(&sessao), tam_id_oferecido);
+    }
+
+    // O pico do handshake é medido a partir do uso atual (sem a conexão anterior)
+    pico_tentativa = est.heap_atual;
+}
+
+/**
+ * @brief Contabiliza a conexão e guarda a sessão negociada para a próxima.
+ *
+ * A retomada só é contada se o servidor devolveu o ID oferecido; um ID diferente
+ * significa que ele recusou a sessão e fez o handshake completo.
+ */
+void tls_mqtt_conectado(struct altcp_pcb *conn, int broker, uint32_t tempo_us) {
+    // A sessão desta conexão substitui a guardada (no mbedTLS 3, só pode ser exportada uma vez)
+    descartar_sessao();
+    mbedtls_ssl_session_init(&sessao);
+    sessao_valida = mbedtls_ssl_get_session(altcp_tls_context(conn), &sessao) == 0;
+
+    bool retomada = sessao_valida && tam_id_oferecido &&
+                    mbedtls_ssl_session_get_id_len(&sessao) == tam_id_oferecido &&
+                    memcmp(mbedtls_ssl_session_get_id(&sessao), id_oferecido, tam_id_oferecido) == 0;
+    if (tam_id_oferecido && !retomada) {
+        est.recusadas++;
+    }
+
+    if (retomada) {
+        est.retomadas++;
+        soma_retomada_us += tempo_us;
+        est.media_retomada_us = (uint32_t)(soma_retomada_us / est.retomadas);
+        if (tempo_us > est.max_retomada_us) {
+            est.max_retomada_us = tempo_us;
+        }
+        if (pico_tentativa > est.heap_pico_retomada) {
+            est.heap_pico_retomada = pico_tentativa;
+        }
+    } else {
+        est.completas++;
+        soma_completa_us += tempo_us;
+        est.media_completa_us = (uint32_t)(soma_completa_us / est.completas);
+        if (tempo_us > est.max_completa_us) {
+            est.max_completa_us = tempo_us;
+        }
+        if (pico_tentativa > est.heap_pico_completa) {
+            est.heap_pico_completa = pico_tentativa;
+        }
+    }
+    printf("[TLS] Conectado em %lu ms (%s)\n", (unsigned long)(tempo_us / 1000),
+           retomada ? "sessão retomada" : tam_id_oferecido ? "sessão recusada, handshake completo"
+                                                           : "handshake completo");
+
+    if (sessao_valida) {
+        broker_sessao = broker;
+    } else {
+        mbedtls_ssl_session_free(&sessao);
+    }
+    tam_id_oferecido = 0;
+}
+
+void tls_mqtt_falhou(int broker) {
+    // Sessão recusada de forma não recuperável: a próxima tentativa faz o handshake completo
+    if (tam_id_oferecido && broker == broker_sessao) {
+        descartar_sessao();
+    }
+    tam_id_oferecido = 0;
+}
+
+void tls_mqtt_estatisticas(EstatisticasTls *e) {
+    *e = est;
+}
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file tls_mqtt.h
+ * @brief Transporte TLS (altcp_tls + mbedTLS) do cliente MQTT, com retomada de sessão.
+ *
+ * Compilado apenas com `MQTT_USAR_TLS` (opção `MQTT_TLS` do CMake). A configuração TLS
+ * é criada uma única vez; a cada conexão aceita, a sessão negociada é guardada e
+ * oferecida pelo seu ID na próxima conexão ao mesmo broker, o que evita a troca de
+ * chaves completa nas reconexões.
+ *
+ * Para medir o custo, o módulo separa o tempo até o CONNACK das conexões retomadas
+ * (o servidor devolveu o ID oferecido) e das completas, e registra o pico de heap do
+ * mbedTLS (todas as alocações passam por `mbedtls_platform_set_calloc_free()`). Os
+ * tickets ficam desligados (`mbedtls_config.h`): com eles o cliente envia um ID
+ * aleatório e a comparação não diria se a sessão foi aceita.
+ *
+ * Todas as funções rodam sob a trava da lwIP.
+ */
+
+#ifndef TLS_MQTT_H
+#define TLS_MQTT_H
+
+#include "configura_geral.h"
+
+#ifdef MQTT_USAR_TLS
+
+#include "lwip/altcp_tls.h"
+
+typedef struct {
+    uint32_t completas;           // Conexões com handshake completo
+    uint32_t retomadas;           // Servidor devolveu o ID da sessão oferecida
+    uint32_t recusadas;           // Sessão oferecida, mas o servidor fez o handshake completo
+    uint32_t media_completa_us;   // Tempo médio até o CONNACK
+    uint32_t media_retomada_us;
+    uint32_t max_completa_us;
+    uint32_t max_retomada_us;
+    uint32_t heap_atual;          // Bytes alocados pelo mbedTLS agora
+    uint32_t heap_pico;           // Maior valor desde o início
+    uint32_t heap_pico_completa;  // Maior pico durante um handshake completo
+    uint32_t heap_pico_retomada;  // ... e durante um retomado
+} EstatisticasTls;
+
+// Cria a configuração TLS do cliente (CA de MQTT_TLS_CA_CERT, se definida)
+struct altcp_tls_config *tls_mqtt_inicializar(void);
+
+// Logo após mqtt_client_connect(): SNI e sessão guardada deste broker, se houver
+void tls_mqtt_preparar(struct altcp_pcb *conn, int broker, const char *host);
+
+// CONNACK recebido: guarda a sessão e contabiliza o tempo de conexão
+void tls_mqtt_conectado(struct altcp_pcb *conn, int broker, uint32_t tempo_us);
+
+// Falha no handshake ou na conexão: descarta a sessão para não insistir nela
+void tls_mqtt_falhou(int broker);
+
+void tls_mqtt_estatisticas(EstatisticasTls *e);
+
+#endif
+
+#endif
@@ -5,4 +5,4 @@
 
 extern uint8_t status_wifi_rgb;
 
-#endif
\ No newline at end of file
+#endif
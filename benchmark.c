@@ -0,0 +1,515 @@
+/**
+ * @file benchmark.c
+ * @brief Varredura de carga do caminho de publicação MQTT, com saída em linhas JSON.
+ *
+ * Um alarme periódico no ritmo da taxa do caso sinaliza `EVT_BENCHMARK`; a cada
+ * sinal, o laço principal publica uma mensagem (ou, na taxa ilimitada, tantas
+ * quantas a fila de saída aceitar).
+ *
+ * Antes da varredura, as telas do firmware são redesenhadas uma vez para medir os
+ * bytes enviados ao OLED com o rastreamento de páginas sujas, e o custo de um quadro
+ * inteiro é comparado com o do transporte anterior (cópia para um buffer do heap).
+ * A vazão do desenho de texto (caracteres por segundo) é medida só no framebuffer.
+ * Por fim, os ciclos por operação da fila SPSC são comparados com os da fila com mutex.
+ */
+
+#include "benchmark.h"
+#include "mqtt_lwip.h"
+#include "nucleo_rede.h"
+#include "fila_publicacao.h"
+#include "histograma_hdr.h"
+#include "lote_telemetria.h"
+#include "eventos.h"
+#include "configura_geral.h"
+#include "ssd1306_i2c.h"
+#include "ssd1306.h"
+#include "oled_utils.h"
+#include "estado_mqtt.h"
+#include "fila_circular.h"
+#include "protocolo_nucleos.h"
+#include "pico/mutex.h"
+#include "hardware/structs/systick.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCHMARK_TICK_LIVRE_US 1000   // Período do alarme na taxa ilimitada
+#define BENCHMARK_QUADROS_OLED  16     // Repetições da medição do custo do quadro
+#define BENCHMARK_TEXTO_OLED    200    // Passadas sobre os textos do firmware
+#define BENCHMARK_FILA          1000   // Rodadas de TAM_FILA inserções + TAM_FILA remoções
+
+typedef enum {
+    BENCH_PARADO = 0,
+    BENCH_AGUARDANDO_CONEXAO,
+    BENCH_ENVIANDO,
+    BENCH_DRENANDO,
+    BENCH_CONCLUIDO,
+} EstadoBenchmark;
+
+static const uint16_t tamanhos[] = { 16, 48, 200 };   // Por registro; 200 × 4 não cabe e é pulado
+static const uint8_t lotes[] = { 1, 4 };
+static const uint8_t qos_casos[] = { 0, 1 };
+static const uint16_t taxas[] = { 50, 200, 0 };   // msgs/s; 0 = o máximo que a fila aceitar
+
+#define N_TAMANHOS (sizeof(tamanhos) / sizeof(tamanhos[0]))
+#define N_LOTES    (sizeof(lotes) / sizeof(lotes[0]))
+#define N_QOS      (sizeof(qos_casos) / sizeof(qos_casos[0]))
+#define N_TAXAS    (sizeof(taxas) / sizeof(taxas[0]))
+#define N_CASOS    (N_TAMANHOS * N_LOTES * N_QOS * N_TAXAS)
+
+static EstadoBenchmark estado = BENCH_PARADO;
+static uint32_t caso = 0;
+static uint16_t tamanho, taxa;
+static uint8_t lote, qos;
+
+static uint8_t payload[MQTT_TAM_PAYLOAD];
+static uint16_t tam_payload;
+static HistogramaHdr latencias;
+static repeating_timer_t temporizador;
+static bool temporizador_ativo = false;
+
+static absolute_time_t fim_fase;
+static uint64_t inicio_us;
+static uint64_t cpu_us;
+static uint32_t enviados, recusados, confirmadas_inicio;
+
+static bool tick_cb(repeating_timer_t *t) {
+    eventos_sinalizar(EVT_BENCHMARK);
+    return true;
+}
+
+static void armar_temporizador(int64_t periodo_us) {
+    if (temporizador_ativo) {
+        cancel_repeating_timer(&temporizador);
+    }
+    // Período negativo: intervalo medido entre inícios, sem acumular atraso
+    temporizador_ativo = add_repeating_timer_us(-periodo_us, tick_cb, NULL, &temporizador);
+}
+
+static uint32_t confirmadas_atuais(uint32_t *profundidade) {
+    EstatisticasPublicacao est;
+    nucleo_rede_travar();
+    fila_publicacao_estatisticas(&est);
+    nucleo_rede_destravar();
+    if (profundidade) {
+        *profundidade = est.profundidade;
+    }
+    return est.confirmadas;
+}
+
+// Monta o payload do caso no mesmo enquadramento de lote_telemetria.h
+static bool montar_payload(void) {
+    uint32_t total = 2 + (uint32_t)lote * (1 + tamanho);
+    if (lote == 1) {
+        total = tamanho;
+    }
+    if (total > MQTT_TAM_PAYLOAD) {
+        return false;
+    }
+
+    memset(payload, 0x5A, sizeof(payload));
+    if (lote > 1) {
+        payload[0] = LOTE_VERSAO;
+        payload[1] = lote;
+        for (uint32_t i = 0; i < lote; i++) {
+            payload[2 + i * (1 + tamanho)] = (uint8_t)tamanho;
+        }
+    }
+    tam_payload = (uint16_t)total;
+    return true;
+}
+
+// Seleciona o caso `caso` da varredura; false se ele não couber no payload máximo
+static bool configurar_caso(void) {
+    uint32_t i = caso;
+    taxa = taxas[i % N_TAXAS];       i /= N_TAXAS;
+    qos = qos_casos[i % N_QOS];      i /= N_QOS;
+    lote = lotes[i % N_LOTES];       i /= N_LOTES;
+    tamanho = tamanhos[i % N_TAMANHOS];
+    return montar_payload();
+}
+
+static void iniciar_caso(void) {
+    while (caso < N_CASOS && !configurar_caso()) {
+        caso++;
+    }
+    if (caso >= N_CASOS) {
+        estado = BENCH_CONCLUIDO;
+        if (temporizador_ativo) {
+            cancel_repeating_timer(&temporizador);
+            temporizador_ativo = false;
+        }
+        nucleo_rede_travar();
+        fila_publicacao_medir_latencias(NULL);
+        nucleo_rede_destravar();
+        printf("{\"bench\":\"fim\",\"casos\":%u}\n", (unsigned)N_CASOS);
+        return;
+    }
+
+    hdr_zerar(&latencias);
+    nucleo_rede_travar();
+    fila_publicacao_medir_latencias(&latencias);
+    nucleo_rede_destravar();
+
+    enviados = recusados = 0;
+    cpu_us = 0;
+    confirmadas_inicio = confirmadas_atuais(NULL);
+    nucleo_rede_zerar_estatisticas();
+    inicio_us = time_us_64();
+    fim_fase = make_timeout_time_ms(BENCHMARK_DURACAO_MS);
+    estado = BENCH_ENVIANDO;
+    armar_temporizador(taxa ? 1000000 / taxa : BENCHMARK_TICK_LIVRE_US);
+}
+
+static void enviar(void) {
+    uint32_t n = taxa ? 1 : MQTT_FILA_PUB_TAM;
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t t0 = time_us_64();
+        bool aceita = mqtt_enfileirar(BENCHMARK_TOPICO, payload, tam_payload, qos, 0, PRIORIDADE_ALTA);
+        cpu_us += time_us_64() - t0;
+        if (!aceita) {
+            recusados++;
+            break;
+        }
+        enviados++;
+    }
+}
+
+static void concluir_caso(void) {
+    EstatisticasNucleoRede rede;
+    nucleo_rede_estatisticas(&rede);   // Antes das leituras abaixo, que também tomam a trava
+    uint32_t confirmados = confirmadas_atuais(NULL) - confirmadas_inicio;
+    uint64_t duracao_us = time_us_64() - inicio_us;
+    uint32_t msgs_mili = (uint32_t)((uint64_t)confirmados * 1000000000ull / duracao_us);  // msgs/s × 1000
+    uint32_t regs_mili = msgs_mili * lote;
+
+    nucleo_rede_travar();
+    uint32_t p50 = hdr_percentil(&latencias, 500);
+    uint32_t p99 = hdr_percentil(&latencias, 990);
+    nucleo_rede_destravar();
+
+    printf("{\"bench\":\"mqtt_pub\",\"payload\":%u,\"lote\":%u,\"qos\":%u,\"taxa\":%u,"
+           "\"enviados\":%lu,\"recusados\":%lu,\"confirmados\":%lu,"
+           "\"msgs_s\":%lu.%01lu,\"registros_s\":%lu.%01lu,"
+           "\"p50_us\":%lu,\"p99_us\":%lu,\"cpu_us_msg\":%lu}\n",
+           tamanho, lote, qos, taxa,
+           (unsigned long)enviados, (unsigned long)recusados, (unsigned long)confirmados,
+           (unsigned long)(msgs_mili / 1000), (unsigned long)(msgs_mili % 1000 / 100),
+           (unsigned long)(regs_mili / 1000), (unsigned long)(regs_mili % 1000 / 100),
+           (unsigned long)p50, (unsigned long)p99,
+           (unsigned long)(enviados ? cpu_us / enviados : 0));
+
+    printf("{\"bench\":\"rede\",\"nucleo_unico\":%d,\"payload\":%u,\"lote\":%u,\"qos\":%u,\"taxa\":%u,"
+           "\"travas_n0\":%lu,\"contidas_n0\":%lu,\"espera_max_n0_us\":%lu,\"espera_total_n0_us\":%llu,"
+           "\"travas_n1\":%lu,\"contidas_n1\":%lu,\"espera_max_n1_us\":%lu,\"espera_total_n1_us\":%llu,"
+           "\"comandos\":%lu,\"fila_cheia\":%lu,\"submissao_p50_us\":%lu,\"submissao_p99_us\":%lu}\n",
+           REDE_NUCLEO_UNICO, tamanho, lote, qos, taxa,
+           (unsigned long)rede.aquisicoes[0], (unsigned long)rede.contidas[0],
+           (unsigned long)rede.espera_max_us[0], (unsigned long long)rede.espera_total_us[0],
+           (unsigned long)rede.aquisicoes[1], (unsigned long)rede.contidas[1],
+           (unsigned long)rede.espera_max_us[1], (unsigned long long)rede.espera_total_us[1],
+           (unsigned long)rede.comandos, (unsigned long)rede.fila_cheia,
+           (unsigned long)rede.latencia_p50_us, (unsigned long)rede.latencia_p99_us);
+
+    caso++;
+    iniciar_caso();
+}
+
+// ========================
+// BYTES ENVIADOS AO OLED
+// ========================
+
+static EstatisticasOled oled_antes;
+
+static void iniciar_tela(void) {
+    ssd1306_estatisticas(&oled_antes);
+}
+
+static void concluir_tela(const char *nome) {
+    EstatisticasOled depois;
+    ssd1306_flush_aguardar();   // Inclui o envio agrupado nos bytes desta tela
+    ssd1306_estatisticas(&depois);
+    printf("{\"bench\":\"oled\",\"tela\":\"%s\",\"renders\":%lu,\"janelas\":%lu,"
+           "\"bytes\":%lu,\"bytes_quadro\":%lu,\"transacoes\":%lu,\"enderecamentos_evitados\":%lu}\n",
+           nome,
+           (unsigned long)(depois.quadros - oled_antes.quadros),
+           (unsigned long)(depois.janelas - oled_antes.janelas),
+           (unsigned long)(depois.bytes - oled_antes.bytes),
+           (unsigned long)(depois.bytes_quadro_inteiro - oled_antes.bytes_quadro_inteiro),
+           (unsigned long)(depois.transacoes - oled_antes.transacoes),
+           (unsigned long)(depois.enderecamentos_evitados - oled_antes.enderecamentos_evitados));
+}
+
+// Repete as sequências de desenho das telas existentes (main.c, main_auxiliar.c, linha_tempo.c)
+static void medir_telas_oled(void) {
+    oled_clear(buffer_oled, &area);
+
+    iniciar_tela();
+    ssd1306_draw_utf8_multiline(buffer_oled, 0, 0, "Núcleo 0");
+    ssd1306_draw_utf8_multiline(buffer_oled, 0, 16, "Iniciando!");
+    render_on_display(buffer_oled, &area);
+    concluir_tela("splash");
+
+    iniciar_tela();
+    oled_clear(buffer_oled, &area);
+    concluir_tela("limpeza");
+
+    iniciar_tela();
+    ssd1306_draw_utf8_multiline(buffer_oled, 0, 0, "Status do Wi-Fi : CONECTADO");
+    render_on_display(buffer_oled, &area);
+    concluir_tela("status_wifi");
+
+    iniciar_tela();
+    oled_clear(buffer_oled, &area);
+    ssd1306_draw_utf8_string(buffer_oled, 0, 0, "192.168.100.200");
+    render_on_display(buffer_oled, &area);
+    concluir_tela("ip");
+
+    iniciar_tela();
+    ssd1306_draw_utf8_string(buffer_oled, 0, 16, "MQTT: ");
+    ssd1306_draw_utf8_string(buffer_oled, 40, 16, "CONECTADO");
+    render_on_display(buffer_oled, &area);
+    concluir_tela("status_mqtt");
+
+    for (int i = 0; i < 2; i++) {
+        iniciar_tela();
+        ssd1306_draw_utf8_multiline(buffer_oled, 0, 0, "PING enviado...");
+        ssd1306_draw_utf8_multiline(buffer_oled, 0, 48, i ? "RTT 12.4/31.0ms " : "RTT 11.9/30.2ms ");
+        render_on_display(buffer_oled, &area);
+        concluir_tela(i ? "ping_repetido" : "ping");
+    }
+
+    iniciar_tela();
+    ssd1306_draw_utf8_multiline(buffer_oled, 0, 32, "ACK do PING OK");
+    render_on_display(buffer_oled, &area);
+    concluir_tela("ack");
+
+    oled_clear(buffer_oled, &area);
+}
+
+/**
+ * @brief Custo de um quadro inteiro: cópia que o transporte anterior fazia e envio atual.
+ *
+ * `copia_heap_us` reproduz o malloc + memcpy + free de cada envio anterior; o transporte
+ * atual não tem esse custo. `render_cpu_us` é o tempo do núcleo 0 dentro de
+ * render_on_display() e `render_total_us` inclui a transferência pelo DMA.
+ */
+static void medir_quadro_oled(void) {
+    uint64_t copia_us = 0, cpu_us = 0, total_us = 0;
+
+    for (int i = 0; i < BENCHMARK_QUADROS_OLED; i++) {
+        uint64_t t0 = time_us_64();
+        uint8_t *temp = malloc(ssd1306_frame_length);
+        temp[0] = ssd1306_data_control;
+        memcpy(temp + 1, buffer_oled, ssd1306_buffer_length);
+        free(temp);
+        copia_us += time_us_64() - t0;
+
+        ssd1306_marcar_tudo();
+        t0 = time_us_64();
+        render_on_display(buffer_oled, &area);
+        cpu_us += time_us_64() - t0;
+        ssd1306_flush_aguardar();
+        total_us += time_us_64() - t0;
+    }
+
+    printf("{\"bench\":\"oled_quadro\",\"bytes\":%u,\"copia_heap_us\":%lu,"
+           "\"render_cpu_us\":%lu,\"render_total_us\":%lu}\n", (unsigned)ssd1306_frame_length,
+           (unsigned long)(copia_us / BENCHMARK_QUADROS_OLED),
+           (unsigned long)(cpu_us / BENCHMARK_QUADROS_OLED),
+           (unsigned long)(total_us / BENCHMARK_QUADROS_OLED));
+}
+
+// Textos desenhados por main.c e main_auxiliar.c (com as linhas de linha_tempo_mostrar_oled)
+static const char *const textos_oled[] = {
+    "Núcleo 0", "Iniciando!", "PING enviado...", "RTT 12.4/31.0ms ", "ACK do PING OK",
+    "ACK do PING FALHOU", "Status do Wi-Fi : CONECTADO", "Status inválido.",
+    "192.168.100.200", "MQTT: ", "CONECTADO",
+};
+
+static uint32_t contar_caracteres(const char *s) {
+    uint32_t n = 0;
+    for (; *s; s++) {
+        n += ((uint8_t)*s & 0xC0) != 0x80;   // Bytes de continuação não contam
+    }
+    return n;
+}
+
+/**
+ * @brief Caracteres por segundo de ssd1306_draw_utf8_string() e ssd1306_draw_utf8_multiline().
+ *
+ * Textos consecutivos são desenhados no mesmo lugar, então cada passada regrava glifos
+ * (o caso em que nada muda é o mais barato e não é o que se quer medir). O
+ * framebuffer é limpo no fim, sem medir o envio ao display.
+ */
+static void medir_texto_oled(void) {
+    uint32_t caracteres = 0;
+    for (size_t i = 0; i < count_of(textos_oled); i++) {
+        caracteres += contar_caracteres(textos_oled[i]);
+    }
+    caracteres *= BENCHMARK_TEXTO_OLED;
+
+    uint64_t t0 = time_us_64();
+    for (int r = 0; r < BENCHMARK_TEXTO_OLED; r++) {
+        for (size_t i = 0; i < count_of(textos_oled); i++) {
+            ssd1306_draw_utf8_string(buffer_oled, 0, 0, textos_oled[i]);
+        }
+    }
+    uint32_t linha_us = (uint32_t)(time_us_64() - t0);
+
+    t0 = time_us_64();
+    for (int r = 0; r < BENCHMARK_TEXTO_OLED; r++) {
+        for (size_t i = 0; i < count_of(textos_oled); i++) {
+            ssd1306_draw_utf8_multiline(buffer_oled, 0, 16, textos_oled[i]);
+        }
+    }
+    uint32_t multilinha_us = (uint32_t)(time_us_64() - t0);
+
+    oled_clear(buffer_oled, &area);
+    ssd1306_flush_aguardar();
+
+    printf("{\"bench\":\"oled_texto\",\"caracteres\":%lu,\"string_chars_s\":%lu,"
+           "\"multiline_chars_s\":%lu}\n", (unsigned long)caracteres,
+           (unsigned long)((uint64_t)caracteres * 1000000u / MAX(linha_us, 1u)),
+           (unsigned long)((uint64_t)caracteres * 1000000u / MAX(multilinha_us, 1u)));
+}
+
+// Fila anterior, protegida por mutex, reproduzida só para a comparação
+typedef struct {
+    MensagemNucleo fila[TAM_FILA];
+    int frente;
+    int tras;
+    int tamanho;
+    mutex_t mutex;
+} FilaMutex;
+
+static bool fila_mutex_inserir(FilaMutex *f, const MensagemNucleo *m) {
+    bool sucesso = false;
+    mutex_enter_blocking(&f->mutex);
+    if (f->tamanho < TAM_FILA) {
+        f->tras = (f->tras + 1) % TAM_FILA;
+        f->fila[f->tras] = *m;
+        f->tamanho++;
+        sucesso = true;
+    }
+    mutex_exit(&f->mutex);
+    return sucesso;
+}
+
+static bool fila_mutex_remover(FilaMutex *f, MensagemNucleo *saida) {
+    bool sucesso = false;
+    mutex_enter_blocking(&f->mutex);
+    if (f->tamanho > 0) {
+        *saida = f->fila[f->frente];
+        f->frente = (f->frente + 1) % TAM_FILA;
+        f->tamanho--;
+        sucesso = true;
+    }
+    mutex_exit(&f->mutex);
+    return sucesso;
+}
+
+// SysTick conta para baixo em 24 bits no clock do processador
+static inline uint32_t ciclos_desde(uint32_t inicio) {
+    return (inicio - systick_hw->cvr) & 0x00FFFFFFu;
+}
+
+/**
+ * @brief Ciclos por operação da fila SPSC e da fila anterior com mutex.
+ *
+ * O RP2040 não tem contador de ciclos (DWT); o SysTick no clock do processador faz o
+ * papel. Cada rodada enche e esvazia a fila com `MensagemNucleo` (o elemento
+ * trocado entre os núcleos), sem disputa entre núcleos: mede-se o custo fixo de cada operação.
+ */
+static void medir_fila_circular(void) {
+    static FilaMutex fila_mutex;
+    static FilaCircular fila_spsc;
+    FILA_DECLARAR_BUFFER(buffer_spsc, MensagemNucleo, TAM_FILA);
+    MensagemNucleo msg = {.tipo = MSG_RSSI, .n_palavras = 1};
+    uint32_t ciclos_mutex = 0, ciclos_spsc = 0;
+
+    fila_mutex.frente = 0;
+    fila_mutex.tras = -1;
+    fila_mutex.tamanho = 0;
+    mutex_init(&fila_mutex.mutex);
+    fila_inicializar(&fila_spsc, buffer_spsc, sizeof(MensagemNucleo), TAM_FILA);
+
+    uint32_t csr = systick_hw->csr, rvr = systick_hw->rvr;
+    systick_hw->rvr = 0x00FFFFFFu;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;   // Habilitado, clock do processador, sem interrupção
+
+    for (int r = 0; r < BENCHMARK_FILA; r++) {
+        uint32_t t0 = systick_hw->cvr;
+        for (int i = 0; i < TAM_FILA; i++) {
+            fila_mutex_inserir(&fila_mutex, &msg);
+        }
+        for (int i = 0; i < TAM_FILA; i++) {
+            fila_mutex_remover(&fila_mutex, &msg);
+        }
+        ciclos_mutex += ciclos_desde(t0);
+
+        t0 = systick_hw->cvr;
+        for (int i = 0; i < TAM_FILA; i++) {
+            fila_inserir(&fila_spsc, &msg);
+        }
+        for (int i = 0; i < TAM_FILA; i++) {
+            fila_remover(&fila_spsc, &msg);
+        }
+        ciclos_spsc += ciclos_desde(t0);
+    }
+
+    systick_hw->csr = csr;
+    systick_hw->rvr = rvr;
+
+    uint32_t operacoes = 2u * TAM_FILA * BENCHMARK_FILA;
+    printf("{\"bench\":\"fila\",\"elemento\":%u,\"operacoes\":%lu,"
+           "\"mutex_ciclos_op\":%lu,\"spsc_ciclos_op\":%lu}\n", (unsigned)sizeof(MensagemNucleo),
+           (unsigned long)operacoes, (unsigned long)(ciclos_mutex / operacoes),
+           (unsigned long)(ciclos_spsc / operacoes));
+}
+
+void benchmark_iniciar(void) {
+    medir_telas_oled();
+    medir_quadro_oled();
+    medir_texto_oled();
+    medir_fila_circular();
+
+    caso = 0;
+    estado = BENCH_AGUARDANDO_CONEXAO;
+    armar_temporizador(500000);
+}
+
+void benchmark_processar(void) {
+    uint32_t profundidade;
+
+    switch (estado) {
+        case BENCH_AGUARDANDO_CONEXAO:
+            if (mqtt_esta_conectado()) {
+                printf("{\"bench\":\"inicio\",\"casos\":%u,\"duracao_ms\":%u}\n",
+                       (unsigned)N_CASOS, BENCHMARK_DURACAO_MS);
+                iniciar_caso();
+            }
+            break;
+
+        case BENCH_ENVIANDO:
+            if (time_reached(fim_fase)) {
+                estado = BENCH_DRENANDO;
+                fim_fase = make_timeout_time_ms(BENCHMARK_DRENO_MS);
+                armar_temporizador(10000);
+            } else {
+                enviar();
+            }
+            break;
+
+        case BENCH_DRENANDO:
+            confirmadas_atuais(&profundidade);
+            if (profundidade == 0 || time_reached(fim_fase)) {
+                concluir_caso();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * @file benchmark.h
+ * @brief Modo de benchmark do caminho de publicação MQTT (compilado com `-DMQTT_BENCHMARK=ON`).
+ *
+ * Substitui o PING periódico por uma varredura de tamanho de payload, registros por
+ * PUBLISH, QoS e taxa de envio contra o broker configurado. Cada caso imprime uma
+ * linha JSON na saída padrão, por exemplo:
+ *
+ *   {"bench":"mqtt_pub","payload":48,"lote":4,"qos":1,"taxa":200,"enviados":600,
+ *    "recusados":0,"confirmados":600,"msgs_s":199.8,"registros_s":799.2,
+ *    "p50_us":5120,"p99_us":12800,"cpu_us_msg":41}
+ *
+ * `p50_us`/`p99_us` medem da entrada na fila até a confirmação (PUBACK no QoS 1,
+ * envio no QoS 0); `cpu_us_msg` é o tempo do núcleo 0 gasto para codificar e
+ * enfileirar cada mensagem. Um script no host pode comparar as linhas entre versões.
+ *
+ * Após cada caso, uma linha `rede` traz a contenção da trava da lwIP por núcleo e a
+ * latência da submissão até a fila de saída (`nucleo_rede.h`) no mesmo intervalo:
+ *
+ *   {"bench":"rede","nucleo_unico":1,"payload":48,"lote":4,"qos":1,"taxa":200,
+ *    "travas_n0":...,"contidas_n0":...,"espera_max_n0_us":...,"espera_total_n0_us":...,
+ *    "travas_n1":...,...,"submissao_p50_us":...,"submissao_p99_us":...}
+ *
+ * O "antes e depois" do núcleo de rede é a comparação dessas linhas entre um firmware
+ * compilado com `-DREDE_NUCLEO_UNICO=OFF` (núcleo 0 toma a trava) e outro com `ON`.
+ *
+ * No início, cada tela do firmware é redesenhada e os bytes enviados ao OLED são impressos:
+ *
+ *   {"bench":"oled","tela":"ping_repetido","renders":1,"janelas":1,"bytes":68,"bytes_quadro":1037}
+ *
+ * `bytes_quadro` é o custo das mesmas chamadas enviando a área inteira (o envio anterior).
+ * Em seguida, uma linha `oled_quadro` compara o custo de um quadro inteiro antes (cópia
+ * para o heap) e depois (envio sem cópia).
+ *
+ * A linha `fila` compara os ciclos por operação da fila SPSC e da fila anterior com mutex:
+ *
+ *   {"bench":"fila","elemento":28,"operacoes":32000,"mutex_ciclos_op":...,"spsc_ciclos_op":...}
+ *
+ * O teste concorrente da fila roda no host (testes_host/).
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#define BENCHMARK_DURACAO_MS  3000   // Fase de envio de cada caso
+#define BENCHMARK_DRENO_MS    3000   // Espera máxima pelas confirmações restantes
+#define BENCHMARK_TOPICO      "pico/bench"
+
+// Começa a varredura assim que o broker aceitar a conexão
+void benchmark_iniciar(void);
+
+// Avança a varredura (laço principal, em EVT_BENCHMARK)
+void benchmark_processar(void);
+
+#endif
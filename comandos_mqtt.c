@@ -0,0 +1,190 @@
+/**
+ * @file comandos_mqtt.c
+ * @brief Tratadores dos comandos MQTT e sua aplicação no núcleo 0.
+ *
+ * Os números são lidos de forma incremental, fragmento a fragmento, direto do
+ * buffer da lwIP; apenas o texto do OLED é copiado, para o buffer de destino.
+ * Cada comando tem um único produtor (núcleo 1) e um único consumidor (núcleo 0):
+ * o produtor escreve o valor e só então publica a flag `pendente`.
+ */
+
+#include "comandos_mqtt.h"
+#include "assinaturas_mqtt.h"
+#include "mqtt_lwip.h"
+#include "eventos.h"
+#include "estado_mqtt.h"
+#include "linha_tempo.h"
+#include "rgb_pwm_control.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+#include <string.h>
+
+#define COMANDO_MAX_NUMEROS 3
+
+// Leitura incremental de até três números decimais separados por qualquer não dígito
+typedef struct {
+    uint32_t valores[COMANDO_MAX_NUMEROS];
+    uint8_t n;
+    bool em_numero;
+} LeitorNumeros;
+
+static void leitor_numeros_consumir(LeitorNumeros *l, const FragmentoMQTT *f) {
+    if (f->deslocamento == 0) {
+        memset(l, 0, sizeof(*l));
+    }
+    for (uint16_t i = 0; i < f->tamanho; i++) {
+        uint8_t c = f->dados[i];
+        if (c >= '0' && c <= '9') {
+            if (!l->em_numero) {
+                if (l->n == COMANDO_MAX_NUMEROS) {
+                    return;
+                }
+                l->em_numero = true;
+                l->n++;
+            }
+            l->valores[l->n - 1] = l->valores[l->n - 1] * 10 + (c - '0');
+        } else {
+            l->em_numero = false;
+        }
+    }
+}
+
+// ========================
+// ESTADO PENDENTE (núcleo 1 → núcleo 0)
+// ========================
+
+static volatile bool intervalo_pendente = false;
+static volatile uint32_t intervalo_novo_ms;
+
+static volatile bool led_pendente = false;
+static volatile uint16_t led_novo[3];
+
+static volatile bool texto_pendente = false;
+static char texto_novo[LINHA_TEMPO_MAX_TEXTO];
+static bool recebendo_texto = false;
+
+static volatile uint32_t comandos_descartados = 0;  // Escrito só pelo núcleo 1
+static uint32_t descartados_exibidos = 0;
+
+// ========================
+// TRATADORES (contexto da lwIP, núcleo 1)
+// ========================
+
+static void tratar_intervalo(const FragmentoMQTT *f, void *contexto) {
+    static LeitorNumeros leitor;
+    leitor_numeros_consumir(&leitor, f);
+    if (!f->ultimo) {
+        return;
+    }
+    if (leitor.n != 1 || leitor.valores[0] < COMANDO_INTERVALO_MIN_MS) {
+        comandos_descartados++;
+        return;
+    }
+    intervalo_novo_ms = leitor.valores[0];
+    __dmb();
+    intervalo_pendente = true;
+    eventos_sinalizar(EVT_COMANDO);
+}
+
+static void tratar_led(const FragmentoMQTT *f, void *contexto) {
+    static LeitorNumeros leitor;
+    leitor_numeros_consumir(&leitor, f);
+    if (!f->ultimo) {
+        return;
+    }
+    if (leitor.n != 3) {
+        comandos_descartados++;
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        uint32_t v = leitor.valores[i] > 255 ? 255 : leitor.valores[i];
+        led_novo[i] = (uint16_t)(v * 257);  // 0..255 → 0..65535
+    }
+    __dmb();
+    led_pendente = true;
+    eventos_sinalizar(EVT_COMANDO);
+}
+
+static void tratar_oled(const FragmentoMQTT *f, void *contexto) {
+    if (f->deslocamento == 0) {
+        // Texto anterior ainda não exibido: descarta o novo em vez de sobrescrever
+        recebendo_texto = !texto_pendente;
+        if (!recebendo_texto) {
+            comandos_descartados++;
+        }
+    }
+    if (!recebendo_texto) {
+        return;
+    }
+
+    if (f->deslocamento < sizeof(texto_novo) - 1) {
+        uint32_t n = sizeof(texto_novo) - 1 - f->deslocamento;
+        if (n > f->tamanho) {
+            n = f->tamanho;
+        }
+        memcpy(&texto_novo[f->deslocamento], f->dados, n);
+    }
+
+    if (f->ultimo) {
+        uint32_t fim = f->total < sizeof(texto_novo) - 1 ? f->total : sizeof(texto_novo) - 1;
+        texto_novo[fim] = '\0';
+        recebendo_texto = false;
+        __dmb();
+        texto_pendente = true;
+        eventos_sinalizar(EVT_COMANDO);
+    }
+}
+
+// ========================
+// NÚCLEO 0
+// ========================
+
+static const struct {
+    const char *filtro;
+    TratadorMQTT tratador;
+} assinaturas_cmd[] = {
+    { TOPICO_CMD_INTERVALO, tratar_intervalo },
+    { TOPICO_CMD_LED,       tratar_led },
+    { TOPICO_CMD_OLED,      tratar_oled },
+};
+
+// Assinaturas já aceitas pela fila de comandos; uma nova chamada continua daqui
+static uint32_t assinaturas_submetidas = 0;
+
+bool comandos_inicializar(void) {
+    while (assinaturas_submetidas < sizeof(assinaturas_cmd) / sizeof(assinaturas_cmd[0])) {
+        if (!mqtt_registrar_assinatura(assinaturas_cmd[assinaturas_submetidas].filtro, 1,
+                                       assinaturas_cmd[assinaturas_submetidas].tratador, NULL)) {
+            return false;
+        }
+        assinaturas_submetidas++;
+    }
+    return true;
+}
+
+void comandos_processar(void) {
+    if (intervalo_pendente) {
+        __dmb();
+        intervalo_ping_ms = intervalo_novo_ms;
+        intervalo_pendente = false;
+        printf("[CMD] Intervalo do PING: %lu ms\n", (unsigned long)intervalo_ping_ms);
+    }
+
+    if (led_pendente) {
+        __dmb();
+        set_rgb_pwm(led_novo[0], led_novo[1], led_novo[2]);
+        led_pendente = false;
+    }
+
+    if (texto_pendente) {
+        __dmb();
+        linha_tempo_mostrar_oled(texto_novo, 48, COMANDO_DURACAO_TEXTO_MS);
+        texto_pendente = false;
+    }
+
+    uint32_t descartados = comandos_descartados;
+    if (descartados != descartados_exibidos) {
+        descartados_exibidos = descartados;
+        printf("[CMD] Comandos descartados: %lu\n", (unsigned long)descartados);
+    }
+}
@@ -0,0 +1,33 @@
+/**
+ * @file comandos_mqtt.h
+ * @brief Comandos recebidos por MQTT: intervalo do PING, cor do LED RGB e texto no OLED.
+ *
+ * Tópicos (payload em texto):
+ * - `pico/cmd/intervalo`  → intervalo do PING em ms (ex.: "10000");
+ * - `pico/cmd/led`        → cor "r,g,b" com componentes de 0 a 255;
+ * - `pico/cmd/oled/#`     → texto exibido no OLED por alguns segundos.
+ *
+ * Os tratadores rodam no contexto da lwIP (núcleo 1) e apenas registram o comando;
+ * `comandos_processar()` o aplica no núcleo 0 ao receber `EVT_COMANDO`.
+ */
+
+#ifndef COMANDOS_MQTT_H
+#define COMANDOS_MQTT_H
+
+#include <stdbool.h>
+
+#define TOPICO_CMD_INTERVALO "pico/cmd/intervalo"
+#define TOPICO_CMD_LED       "pico/cmd/led"
+#define TOPICO_CMD_OLED      "pico/cmd/oled/#"
+
+#define COMANDO_INTERVALO_MIN_MS 500
+#define COMANDO_DURACAO_TEXTO_MS 3000
+
+// Registra os tratadores e assina os tópicos (após iniciar_mqtt_cliente()).
+// Retorna false com a fila de comandos cheia; chamar de novo submete só as que faltam.
+bool comandos_inicializar(void);
+
+// Aplica os comandos pendentes (laço principal, em EVT_COMANDO)
+void comandos_processar(void);
+
+#endif
@@ -22,20 +22,105 @@
 #define SDA_PIN 14
 #define SCL_PIN 15
 
+// Boot
+#define BOOT_ESPERAR_USB 0   // 1: aguarda o host USB antes de iniciar (depuração)
+#define BOOT_SPLASH_MS 3000  // Tempo do splash no OLED (não bloqueia)
+
 #define TEMPO_CONEXAO 2000
 #define TEMPO_MENSAGEM 2000
 #define TAM_FILA 16
 
 #define WIFI_SSID "VIVO FIBRA"
 #define WIFI_PASS "19821961aa"
+
+// Reconexão rápida ao Wi-Fi (BSSID, canal e lease em cache_rede.h)
+#define WIFI_VERIFICACAO_MS 200           // Período de verificação do enlace
+#define WIFI_TIMEOUT_DIRECIONADO_MS 1500  // Associação direta ao BSSID/canal em cache
+#define WIFI_PASSO_ESPERA_MS 10           // Intervalo de consulta durante a associação
+#define WIFI_TIMEOUT_ASSOCIACAO_MS 3000   // Associação com varredura e DHCP
+#define WIFI_MAX_TENTATIVAS 5             // Tentativas até reportar falha ao núcleo 0
+#define WIFI_BACKOFF_MAX_MS 30000         // Teto do atraso entre tentativas
+#define WIFI_MAX_ALARMES 6                // Alarm pool do núcleo 1 (Wi-Fi e núcleo de rede)
+#define WIFI_REUSAR_LEASE 1               // Aplica o último lease DHCP logo após associar
+#define WIFI_TIMEOUT_DHCP_MS 1000         // Sem resposta do DHCP: usa o lease em cache ou o IP fixo
+// IP fixo, usado só se o DHCP não responder e não houver lease em cache
+// #define WIFI_IP_FIXO "192.168.15.50"
+// #define WIFI_MASCARA_FIXA "255.255.255.0"
+// #define WIFI_GATEWAY_FIXO "192.168.15.1"
 #define MQTT_BROKER_IP "192.168.15.13"
+#ifdef MQTT_USAR_TLS
+#define MQTT_BROKER_PORT 8883
+#define MQTT_BROKER_PORT_2 8884
+#else
 #define MQTT_BROKER_PORT 1883
+#define MQTT_BROKER_PORT_2 1884
+#endif
+// CA que assinou o certificado do broker (PEM). Sem ela, o certificado não é verificado.
+// #define MQTT_TLS_CA_CERT "-----BEGIN CERTIFICATE-----\n...\n-----END CERTIFICATE-----\n"
+// Brokers em ordem de preferência inicial (nome ou IP, porta); o mais rápido é escolhido.
+// A segunda entrada permite testar o failover com outra instância do mosquitto no mesmo host.
+#define MQTT_BROKERS { { MQTT_BROKER_IP, MQTT_BROKER_PORT }, { MQTT_BROKER_IP, MQTT_BROKER_PORT_2 } }
+#define BROKER_DNS_TTL_MS 300000      // Validade do endereço resolvido
+#define BROKER_SONDAGEM_MS 60000      // Intervalo entre sondas de latência
+#define BROKER_SONDA_TIMEOUT_MS 2000
+#define BROKER_MAX_FALHAS 2           // Falhas seguidas até a quarentena
+#define BROKER_QUARENTENA_MS 30000
+#define BROKER_ESPERA_MS 200          // Nova tentativa enquanto o DNS não responde
 #define TOPICO "pico/PING"
 #define INTERVALO_PING_MS 5000
 
+// Fila de publicação MQTT
+#define MQTT_QOS_PADRAO 1            // QoS usado por publicar_mensagem_mqtt()
+#define MQTT_JANELA_EM_VOO 4         // Publicações aguardando PUBACK ao mesmo tempo
+#define MQTT_FILA_PUB_TAM 8          // Capacidade da fila de saída
+#define MQTT_TAM_TOPICO 32
+#define MQTT_TAM_PAYLOAD 256
+#define MQTT_RETENTATIVA_MEM_MS 50   // Espera antes de repetir após ERR_MEM
+
+// Controle de taxa de publicação (controle_taxa.h)
+#define CONTROLE_TAXA_INICIAL 20     // msgs/s
+#define CONTROLE_TAXA_MIN 2
+#define CONTROLE_TAXA_MAX 200
+#define CONTROLE_TAXA_PASSO 5        // Aumento a cada segundo sem congestionamento
+#define CONTROLE_RAJADA 8            // Capacidade do balde (fichas)
+#define CONTROLE_RESERVA_ALTA 2      // Fichas que a baixa prioridade não pode usar
+#define CONTROLE_REDUCAO_MS 200      // Intervalo mínimo entre reduções da taxa
+
+// Supervisor da conexão MQTT
+#define MQTT_KEEP_ALIVE_S 30         // Keep-alive enviado no CONNECT
+#define MQTT_BACKOFF_BASE_MS 500     // Primeiro atraso de reconexão
+#define MQTT_BACKOFF_MAX_MS 30000    // Teto do backoff exponencial
+#define MQTT_MAX_ASSINATURAS 8
+#define MQTT_MAX_NOS_TOPICO 32        // Nós da trie de filtros (um por nível distinto)
+#define MQTT_TAM_POOL_TOPICOS 256     // Texto dos níveis dos filtros
+
+// Núcleo de rede (nucleo_rede.h)
+#ifndef REDE_NUCLEO_UNICO
+#define REDE_NUCLEO_UNICO 1           // 1: lwIP/MQTT só no núcleo 1; 0: núcleo 0 toma a trava (CMake)
+#endif
+#define REDE_TAM_FILA_COMANDOS 8      // Comandos do núcleo 0 (potência de dois)
+#define REDE_NOVA_SUBMISSAO_MS 50     // Fila de comandos cheia: nova submissão após este atraso
+#define REDE_PERIODO_MS 100           // Passada periódica do supervisor MQTT no núcleo 1
+#define REDE_LIMIAR_CONTENCAO_US 2    // Espera pela trava contada como contenção
+
+// Agrupamento de telemetria (vários registros por PUBLISH)
+#define TOPICO_TELEMETRIA "pico/telemetria"
+#define TOPICO_BOOT "pico/boot"      // Rastro das fases do boot (rastro_boot.h), com retain
+#define MQTT_LOTE_TAM MQTT_TAM_PAYLOAD
+#define MQTT_LOTE_LIMIAR (MQTT_LOTE_TAM * 3 / 4)  // Envia ao atingir este tamanho
+#define MQTT_LOTE_PRAZO_MS 2000                   // ... ou este tempo após o 1º registro
+
+// Registro persistente de publicações feitas sem conexão (registro_flash.h)
+#define REGISTRO_FLASH_SETORES 16         // Últimos 64 KB da flash
+#define REGISTRO_FLASH_TAM_SETOR 4096
+#define REGISTRO_FLASH_TAM_PAGINA 256
+#define REGISTRO_FLASH_POR_CICLO 2        // Mensagens reenviadas por ciclo após reconectar
+#define REGISTRO_FLASH_INTERVALO_MS 100   // Intervalo entre ciclos de reenvio
+#define REGISTRO_FLASH_SINCRONIA_MS 30000 // Tempo máximo de um setor só em RAM
+
 
 // Buffers globais para OLED
-extern uint8_t buffer_oled[];
+extern uint8_t *const buffer_oled;
 extern struct render_area area;
 
 void setup_init_oled(void);
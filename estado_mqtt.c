@@ -9,6 +9,7 @@
  * Ele define:
  * - O último endereço IP recebido (`ultimo_ip_bin`), utilizado para iniciar o cliente MQTT;
  * - Um flag (`mqtt_iniciado`) que garante que o cliente MQTT só será iniciado uma vez;
+ * - O intervalo atual do PING (`intervalo_ping_ms`), ajustável por comando MQTT;
  * - Um buffer de vídeo (`buffer_oled`) para escrita no display OLED;
  * - A estrutura `area`, que define a região da tela sendo desenhada.
  *
@@ -18,6 +19,7 @@
 
 #include "estado_mqtt.h"        // Declaração das variáveis externas
 #include "ssd1306_i2c.h"        // Define tamanho do buffer e estrutura de renderização
+#include "configura_geral.h"    // INTERVALO_PING_MS
 
 // ================================
 // DEFINIÇÕES GLOBAIS ÚNICAS
@@ -39,14 +41,27 @@ uint32_t ultimo_ip_bin = 0;
  */
 bool mqtt_iniciado = false;
 
+/**
+ * @brief Intervalo atual entre PINGs.
+ *
+ * Começa em `INTERVALO_PING_MS` e pode ser alterado pelo tópico `pico/cmd/intervalo`.
+ */
+uint32_t intervalo_ping_ms = INTERVALO_PING_MS;
+
 /**
  * @brief Buffer de vídeo para o display OLED.
  *
  * Este buffer contém os dados de pixels que serão renderizados na tela.
  * Seu tamanho é definido pela função `ssd1306_buffer_length`, de acordo com
- * a resolução do display (tipicamente 128x64).
+ * a resolução do display (tipicamente 128x64). Os pixels ficam logo após o byte
+ * de controle reservado do quadro, para que o driver os envie sem cópia.
+ * O quadro começa no byte 3 de um bloco alinhado, deixando os pixels alinhados a
+ * 4 bytes para a cópia dos glifos por palavra.
  */
-uint8_t buffer_oled[ssd1306_buffer_length];
+static uint8_t quadro_oled[3 + ssd1306_frame_length] __attribute__((aligned(4))) = {
+    [3] = ssd1306_data_control
+};
+uint8_t *const buffer_oled = &quadro_oled[4];
 
 /**
  * @brief Estrutura que define a área da tela a ser desenhada.
@@ -7,9 +7,10 @@
 // Variáveis compartilhadas entre arquivos
 extern uint32_t ultimo_ip_bin;
 extern bool mqtt_iniciado;
+extern uint32_t intervalo_ping_ms;
 
 // Buffer OLED e área global
-extern uint8_t buffer_oled[];
+extern uint8_t *const buffer_oled;
 extern struct render_area area;
 
 #endif
@@ -0,0 +1,110 @@
+/**
+ * @file eventos.c
+ * @brief Implementação do despachante de eventos do núcleo 0 com espera por WFE.
+ *
+ * O conjunto de eventos pendentes é protegido por um spin lock de hardware, pois
+ * pode ser sinalizado tanto por IRQs do núcleo 0 quanto por callbacks da lwIP
+ * executados no núcleo 1. `__sev()` acorda o núcleo 0 mesmo que a sinalização
+ * ocorra entre a verificação dos bits e a instrução `__wfe()`.
+ */
+
+#include "eventos.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+static spin_lock_t *trava_eventos;
+static volatile uint32_t eventos_pendentes = 0;
+
+// Instante da primeira sinalização ainda não despachada de cada evento
+static uint32_t instante_sinal[EVENTOS_N_BITS];
+
+// Histograma de latência sinalização → despacho
+static uint32_t histograma[EVENTOS_N_FAIXAS];
+static uint32_t latencia_max_us = 0;
+
+void eventos_inicializar(void) {
+    trava_eventos = spin_lock_init(spin_lock_claim_unused(true));
+    eventos_pendentes = 0;
+}
+
+/**
+ * @brief Marca eventos como pendentes e acorda o núcleo 0.
+ *
+ * Pode ser chamada de IRQ ou do outro núcleo.
+ */
+void eventos_sinalizar(uint32_t mascara) {
+    uint32_t agora = time_us_32();
+
+    uint32_t estado = spin_lock_blocking(trava_eventos);
+    uint32_t novos = mascara & ~eventos_pendentes;
+    for (int bit = 0; novos; bit++, novos >>= 1) {
+        if (novos & 1) {
+            instante_sinal[bit] = agora;
+        }
+    }
+    eventos_pendentes |= mascara;
+    spin_unlock(trava_eventos, estado);
+
+    __sev();
+}
+
+// Acumula a latência de despacho no histograma logarítmico
+static void registrar_latencia(uint32_t latencia_us) {
+    uint32_t faixa = 0;
+    while (latencia_us && faixa < EVENTOS_N_FAIXAS - 1) {
+        latencia_us >>= 1;
+        faixa++;
+    }
+    histograma[faixa]++;
+}
+
+/**
+ * @brief Dorme até que haja eventos pendentes e os retorna (limpando-os).
+ */
+uint32_t eventos_aguardar(void) {
+    while (true) {
+        uint32_t instantes[EVENTOS_N_BITS];
+
+        uint32_t estado = spin_lock_blocking(trava_eventos);
+        uint32_t pendentes = eventos_pendentes;
+        eventos_pendentes = 0;
+        for (int bit = 0; bit < EVENTOS_N_BITS; bit++) {
+            if (pendentes & (1u << bit)) {
+                instantes[bit] = instante_sinal[bit];
+            }
+        }
+        spin_unlock(trava_eventos, estado);
+
+        if (pendentes) {
+            uint32_t agora = time_us_32();
+            for (int bit = 0; bit < EVENTOS_N_BITS; bit++) {
+                if (pendentes & (1u << bit)) {
+                    uint32_t latencia = agora - instantes[bit];
+                    registrar_latencia(latencia);
+                    if (latencia > latencia_max_us) {
+                        latencia_max_us = latencia;
+                    }
+                }
+            }
+            return pendentes;
+        }
+
+        // Nenhum evento: dorme até IRQ ou __sev() de qualquer núcleo
+        __wfe();
+    }
+}
+
+/**
+ * @brief Imprime o histograma de latência sinalização → despacho no terminal.
+ */
+void eventos_imprimir_histograma(void) {
+    printf("[EVENTOS] Latência de despacho (us), máx %lu:\n", (unsigned long)latencia_max_us);
+    for (int faixa = 0; faixa < EVENTOS_N_FAIXAS; faixa++) {
+        if (histograma[faixa] == 0) {
+            continue;
+        }
+        uint32_t inicio = faixa ? (1u << (faixa - 1)) : 0;
+        printf("  >= %6lu: %lu\n", (unsigned long)inicio, (unsigned long)histograma[faixa]);
+    }
+}
@@ -0,0 +1,38 @@
+/**
+ * @file eventos.h
+ * @brief Despachante de eventos do núcleo 0 (substitui o laço com `sleep_ms(50)`).
+ *
+ * Fontes de evento (mensagens do núcleo 1, alarmes do alarm pool, callbacks da lwIP
+ * executados no núcleo 1) chamam `eventos_sinalizar()`, que marca o bit do evento
+ * e executa `__sev()`. O laço principal dorme em `__wfe()` dentro de
+ * `eventos_aguardar()` até que algum bit esteja pendente.
+ *
+ * Para cada evento é registrado o atraso entre a sinalização e o despacho, em um
+ * histograma logarítmico (base 2, em microssegundos).
+ */
+
+#ifndef EVENTOS_H
+#define EVENTOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Bits de evento do núcleo 0
+#define EVT_FIFO        (1u << 0)   // Mensagens do núcleo 1 no anel (protocolo_nucleos.h)
+#define EVT_PING        (1u << 1)   // Prazo do próximo PING atingido
+#define EVT_MQTT        (1u << 2)   // Mudança de estado reportada pela lwIP
+#define EVT_LINHA_TEMPO (1u << 3)   // Prazo de uma ação de exibição/LED atingido
+#define EVT_COMANDO     (1u << 4)   // Comando MQTT recebido (comandos_mqtt.h)
+#define EVT_BENCHMARK   (1u << 5)   // Próximo passo do benchmark (benchmark.h)
+#define EVT_REDE        (1u << 6)   // Cache de associação Wi-Fi a gravar (cache_rede.h)
+#define EVT_OLED        (1u << 7)   // Envio do OLED por DMA concluído (ssd1306_i2c.h)
+
+#define EVENTOS_N_BITS          32
+#define EVENTOS_N_FAIXAS        16  // Faixas do histograma: [0,1), [1,2), [2,4) ... ≥ 2^14 us
+
+void eventos_inicializar(void);
+void eventos_sinalizar(uint32_t mascara);
+uint32_t eventos_aguardar(void);
+void eventos_imprimir_histograma(void);
+
+#endif
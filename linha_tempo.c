@@ -0,0 +1,176 @@
+/**
+ * @file linha_tempo.c
+ * @brief Implementação da agenda de ações com prazo para OLED e LED RGB.
+ *
+ * As ações ficam em um vetor fixo (sem alocação). Um único alarme do alarm pool
+ * fica armado para o prazo mais próximo; ao disparar, ele apenas sinaliza o laço
+ * principal, que executa as ações em contexto normal (fora de IRQ).
+ */
+
+#include "linha_tempo.h"
+#include "eventos.h"
+#include "configura_geral.h"
+#include "rgb_pwm_control.h"
+#include "oled_utils.h"
+#include "ssd1306_i2c.h"
+#include "estado_mqtt.h"
+#include <string.h>
+
+typedef enum {
+    ACAO_LIVRE = 0,
+    ACAO_OLED_TEXTO,
+    ACAO_OLED_LIMPAR,
+    ACAO_LED,
+} TipoAcao;
+
+typedef struct {
+    TipoAcao tipo;
+    absolute_time_t prazo;
+    union {
+        struct {
+            int16_t y;
+            char texto[LINHA_TEMPO_MAX_TEXTO];
+        } oled;
+        struct {
+            uint16_t r, g, b;
+        } led;
+    };
+} AcaoAgendada;
+
+static AcaoAgendada acoes[LINHA_TEMPO_MAX_ACOES];
+static alarm_id_t alarme_armado = 0;
+static absolute_time_t prazo_armado;
+
+void linha_tempo_inicializar(void) {
+    memset(acoes, 0, sizeof(acoes));
+    alarme_armado = 0;
+}
+
+static int64_t alarme_linha_tempo_cb(alarm_id_t id, void *user_data) {
+    alarme_armado = 0;
+    eventos_sinalizar(EVT_LINHA_TEMPO);
+    return 0;
+}
+
+// Mantém um alarme armado para o prazo mais próximo entre as ações pendentes
+static void rearmar_alarme(void) {
+    bool ha_pendente = false;
+    absolute_time_t proximo = 0;
+
+    for (int i = 0; i < LINHA_TEMPO_MAX_ACOES; i++) {
+        if (acoes[i].tipo != ACAO_LIVRE &&
+            (!ha_pendente || absolute_time_diff_us(acoes[i].prazo, proximo) > 0)) {
+            proximo = acoes[i].prazo;
+            ha_pendente = true;
+        }
+    }
+
+    if (alarme_armado && (!ha_pendente || absolute_time_diff_us(proximo, prazo_armado) != 0)) {
+        cancel_alarm(alarme_armado);
+        alarme_armado = 0;
+    }
+    if (ha_pendente && !alarme_armado) {
+        prazo_armado = proximo;
+        // fire_if_past = true: prazo já vencido dispara imediatamente
+        alarme_armado = add_alarm_at(proximo, alarme_linha_tempo_cb, NULL, true);
+        if (alarme_armado <= 0) {
+            alarme_armado = 0;
+            eventos_sinalizar(EVT_LINHA_TEMPO);
+        }
+    }
+}
+
+// Reserva uma posição; ações únicas (LED, limpeza) substituem a pendente do mesmo tipo
+static AcaoAgendada *reservar(TipoAcao tipo, uint32_t atraso_ms) {
+    AcaoAgendada *livre = NULL;
+
+    for (int i = 0; i < LINHA_TEMPO_MAX_ACOES; i++) {
+        if (tipo != ACAO_OLED_TEXTO && acoes[i].tipo == tipo) {
+            livre = &acoes[i];
+            break;
+        }
+        if (!livre && acoes[i].tipo == ACAO_LIVRE) {
+            livre = &acoes[i];
+        }
+    }
+
+    if (!livre) {
+        printf("[LINHA DO TEMPO] Agenda cheia. Ação descartada.\n");
+        return NULL;
+    }
+
+    livre->tipo = tipo;
+    livre->prazo = make_timeout_time_ms(atraso_ms);
+    return livre;
+}
+
+void linha_tempo_agendar_texto(uint32_t atraso_ms, const char *texto, int16_t y) {
+    AcaoAgendada *acao = reservar(ACAO_OLED_TEXTO, atraso_ms);
+    if (acao) {
+        strncpy(acao->oled.texto, texto, LINHA_TEMPO_MAX_TEXTO - 1);
+        acao->oled.texto[LINHA_TEMPO_MAX_TEXTO - 1] = '\0';
+        acao->oled.y = y;
+        rearmar_alarme();
+    }
+}
+
+void linha_tempo_agendar_led(uint32_t atraso_ms, uint16_t r, uint16_t g, uint16_t b) {
+    AcaoAgendada *acao = reservar(ACAO_LED, atraso_ms);
+    if (acao) {
+        acao->led.r = r;
+        acao->led.g = g;
+        acao->led.b = b;
+        rearmar_alarme();
+    }
+}
+
+void linha_tempo_agendar_limpeza(uint32_t atraso_ms) {
+    if (reservar(ACAO_OLED_LIMPAR, atraso_ms)) {
+        rearmar_alarme();
+    }
+}
+
+void linha_tempo_mostrar_oled(const char *texto, int16_t y, uint32_t duracao_ms) {
+    ssd1306_draw_utf8_multiline(buffer_oled, 0, y, texto);
+    render_on_display(buffer_oled, &area);
+    linha_tempo_agendar_limpeza(duracao_ms);
+}
+
+void linha_tempo_processar(void) {
+    bool renderizar = false;
+
+    // Passo 0: limpezas vencidas; passo 1: textos e LED (desenhados sobre a tela limpa)
+    for (int passo = 0; passo < 2; passo++) {
+        for (int i = 0; i < LINHA_TEMPO_MAX_ACOES; i++) {
+            AcaoAgendada *acao = &acoes[i];
+            if (acao->tipo == ACAO_LIVRE || !time_reached(acao->prazo) ||
+                (passo == 0) != (acao->tipo == ACAO_OLED_LIMPAR)) {
+                continue;
+            }
+
+            switch (acao->tipo) {
+                case ACAO_OLED_LIMPAR:
+                    ssd1306_limpar_buffer(buffer_oled);
+                    renderizar = true;
+                    break;
+                case ACAO_OLED_TEXTO:
+                    ssd1306_draw_utf8_multiline(buffer_oled, 0, acao->oled.y, acao->oled.texto);
+                    renderizar = true;
+                    break;
+                case ACAO_LED:
+                    set_rgb_pwm(acao->led.r, acao->led.g, acao->led.b);
+                    break;
+                default:
+                    break;
+            }
+            acao->tipo = ACAO_LIVRE;
+        }
+    }
+
+    // Um único envio ao display para todas as ações vencidas nesta rodada
+    if (renderizar) {
+        render_on_display(buffer_oled, &area);
+    }
+
+    rearmar_alarme();
+}
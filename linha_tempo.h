@@ -0,0 +1,35 @@
+/**
+ * @file linha_tempo.h
+ * @brief Agenda não bloqueante de ações de exibição (OLED) e do LED RGB no núcleo 0.
+ *
+ * Substitui os `sleep_ms()` usados para "mostrar X por N ms e depois restaurar":
+ * a ação imediata é executada na hora e a restauração é registrada com um prazo.
+ * `linha_tempo_processar()` executa as ações vencidas e arma um alarme que sinaliza
+ * `EVT_LINHA_TEMPO` no próximo prazo, de modo que nenhum tratador precisa esperar.
+ *
+ * Ações de LED e de limpeza do OLED seguem a regra "a mais recente vence": agendar
+ * uma nova substitui a pendente do mesmo tipo.
+ */
+
+#ifndef LINHA_TEMPO_H
+#define LINHA_TEMPO_H
+
+#include <stdint.h>
+
+#define LINHA_TEMPO_MAX_ACOES   8
+#define LINHA_TEMPO_MAX_TEXTO   32
+
+void linha_tempo_inicializar(void);
+
+// Desenha o texto agora e agenda a limpeza da tela após `duracao_ms`
+void linha_tempo_mostrar_oled(const char *texto, int16_t y, uint32_t duracao_ms);
+
+// Ações adiadas
+void linha_tempo_agendar_texto(uint32_t atraso_ms, const char *texto, int16_t y);
+void linha_tempo_agendar_led(uint32_t atraso_ms, uint16_t r, uint16_t g, uint16_t b);
+void linha_tempo_agendar_limpeza(uint32_t atraso_ms);
+
+// Executa as ações vencidas (chamada no laço principal em EVT_LINHA_TEMPO)
+void linha_tempo_processar(void);
+
+#endif
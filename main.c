@@ -5,41 +5,72 @@
  * Este código é executado no núcleo 0 do RP2040 e desempenha as seguintes funções:
  * - Inicialização da interface OLED para exibição de mensagens ao usuário;
  * - Inicialização do PWM para controle de um LED RGB;
- * - Comunicação com o núcleo 1 por meio de FIFO para receber mensagens relacionadas à conexão Wi-Fi;
+ * - Comunicação com o núcleo 1 por um anel em memória compartilhada (`protocolo_nucleos.h`)
+ *   para receber mensagens relacionadas à conexão Wi-Fi;
  * - Exibição e tratamento das mensagens de status do Wi-Fi;
  * - Inicialização do cliente MQTT após o recebimento do IP válido;
- * - Envio periódico da mensagem "PING" via MQTT;
+ * - Envio periódico do PING via MQTT (CBOR com sequência e instante de envio) e medição
+ *   do RTT pelo eco recebido do broker (`rtt_ping.h`);
  * - Exibição da confirmação da publicação MQTT recebida do núcleo 1.
+ *
+ * O laço principal é orientado a eventos (`eventos.h`): o núcleo dorme em WFE e é
+ * acordado pelo aviso do núcleo 1, pelo alarme do PING, pelos callbacks da lwIP ou pela
+ * agenda de exibição (`linha_tempo.h`), que substitui as esperas com `sleep_ms()`.
+ *
+ * O boot não espera o host USB (a menos que `BOOT_ESPERAR_USB` seja 1) nem o splash: o
+ * núcleo 1 é lançado antes do OLED e do PWM, para que o Wi-Fi associe enquanto os
+ * periféricos sobem. As fases são marcadas em `rastro_boot.h`.
  */
 
-#include "fila_circular.h"
+#include "protocolo_nucleos.h"
+#include "caixa_mensagens.h"
 #include "rgb_pwm_control.h"
 #include "configura_geral.h"
 #include "oled_utils.h"
 #include "ssd1306_i2c.h"
 #include "mqtt_lwip.h"
+#include "lote_telemetria.h"
+#include "cbor_mini.h"
 #include "lwip/ip_addr.h"
 #include "pico/multicore.h"
 #include <stdio.h>
 #include "estado_mqtt.h"
+#include "eventos.h"
+#include "linha_tempo.h"
+#include "comandos_mqtt.h"
+#include "rtt_ping.h"
+#include "benchmark.h"
+#include "cache_rede.h"
+#include "nucleo_rede.h"
+#include "rastro_boot.h"
 #include <stdlib.h>
 #include <time.h>
 
-#define INTERVALO_PING_MS 5000  // Intervalo entre envios de "PING" (modificável)
+#define TAM_LOTE_FIFO 4         // Mensagens retiradas da caixa por chamada
+#define PINGS_POR_RELATORIO 12  // A cada quantos PINGs o histograma de eventos é impresso
+#define TAM_REGISTRO_TELEMETRIA 8  // Mapa CBOR {chave: int32} no pior caso: 1 + 1 + 5 bytes
+#define TAM_REGISTRO_RTT 25        // Mapa CBOR com 4 pares {chave: u32}: 1 + 4 × (1 + 5) bytes
 
 extern void funcao_wifi_nucleo1(void);
 extern void espera_usb();
 extern void tratar_ip_binario(uint32_t ip_bin);
-extern void tratar_mensagem(MensagemWiFi msg);
+extern void tratar_mensagem(MensagemNucleo msg);
 void inicia_hardware();
 void inicia_core1();
+void inicia_perifericos();
 void verificar_fifo(void);
-void tratar_fila(void);
 void inicializar_mqtt_se_preciso(void);
 void enviar_ping_periodico(void);
+static void receber_nucleo1(void);
+static void verificar_lote(MensagemNucleo *lote, uint32_t n);
+static void agendar_proximo_ping(void);
+static void registrar_telemetria(ChaveTelemetria chave, int32_t valor);
+static void oled_concluido_cb(void);
 
-FilaCircular fila_wifi;
+CaixaMensagens caixa_fifo;      // Preenchida por receber_nucleo1(), consumida por verificar_fifo()
 absolute_time_t proximo_envio;
+static alarm_id_t alarme_inicio_mqtt = 0;
+uint32_t pings_enviados = 0;
 
     char mensagem_str[50];
     bool ip_recebido = false;
@@ -47,110 +78,275 @@ absolute_time_t proximo_envio;
 
     
 int main() {
+    rastro_boot_marcar(BOOT_RELOGIO);
     inicia_hardware();
     inicia_core1();
+    inicia_perifericos();
 
     while (true) {
-        bool mensagem_processada = false;
+        // Dorme (WFE) até que uma IRQ, alarme ou callback da lwIP sinalize algo
+        uint32_t eventos = eventos_aguardar();
 
-        verificar_fifo();
-        tratar_fila();
-        inicializar_mqtt_se_preciso();
-        enviar_ping_periodico();
-        sleep_ms(50);
+        if (eventos & EVT_FIFO) {
+            receber_nucleo1();
+            verificar_fifo();
+            inicializar_mqtt_se_preciso();
+        }
+        if (eventos & EVT_PING) {
+            enviar_ping_periodico();
+        }
+        if (eventos & EVT_MQTT) {
+            mqtt_loop();
+            rastro_boot_relatar();
+        }
+        if (eventos & EVT_LINHA_TEMPO) {
+            linha_tempo_processar();
+        }
+        if (eventos & EVT_COMANDO) {
+            comandos_processar();
+        }
+        if (eventos & EVT_REDE) {
+            cache_rede_processar();
+        }
+        if (eventos & EVT_OLED) {
+            ssd1306_flush_processar();
+        }
+#ifdef MODO_BENCHMARK
+        if (eventos & EVT_BENCHMARK) {
+            benchmark_processar();
+        }
+#endif
     }
 
     return 0;
 }
 /*******************************************************************/
-void verificar_fifo(void) {
-    bool mensagem_processada = false;
+/**
+ * @brief Esvazia o anel do núcleo 1 (`EVT_FIFO`) em `caixa_fifo`.
+ *
+ * Status repetidos são coalescidos na caixa (vale o mais recente); apenas eventos
+ * ordenados podem ser descartados, e isso é contabilizado em `caixa_fifo.descartadas`.
+ */
+static void receber_nucleo1(void) {
+    MensagemNucleo lote[TAM_LOTE_FIFO];
+    uint32_t n;
 
-    if (!multicore_fifo_rvalid()) return;
+    while ((n = protocolo_drenar(lote, TAM_LOTE_FIFO)) > 0) {
+        for (uint32_t i = 0; i < n; i++) {
+            caixa_depositar(&caixa_fifo, &lote[i]);
+        }
+    }
+}
 
-    uint32_t pacote = multicore_fifo_pop_blocking();
-    uint16_t tentativa = pacote >> 16;
+void verificar_fifo(void) {
+    MensagemNucleo lote[TAM_LOTE_FIFO];
+    uint32_t n;
 
-    if (tentativa == 0xFFFE) {
-        uint32_t ip_bin = multicore_fifo_pop_blocking();
-        tratar_ip_binario(ip_bin);
-        ip_recebido = true;
-        return;
+    while ((n = caixa_retirar_lote(&caixa_fifo, lote, TAM_LOTE_FIFO)) > 0) {
+        verificar_lote(lote, n);
     }
+}
 
-    uint16_t status = pacote & 0xFFFF;
+static void verificar_lote(MensagemNucleo *lote, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        MensagemNucleo *msg = &lote[i];
 
-    if (status > 2 && tentativa != 0x9999) {
-        snprintf(mensagem_str, sizeof(mensagem_str),
-                 "Status inválido: %u (tentativa %u)", status, tentativa);
-        ssd1306_draw_utf8_multiline(buffer_oled, 0, 0, "Status inválido.");
-        render_on_display(buffer_oled, &area);
-        sleep_ms(3000);
-        oled_clear(buffer_oled, &area);
-        render_on_display(buffer_oled, &area);
-        printf("%s\n", mensagem_str);
-        return;
-    }
+        switch (msg->tipo) {
+            case MSG_IPV4:
+                tratar_ip_binario(msg->dados[0]);
+                ip_recebido = true;
+                continue;
+            case MSG_RSSI:
+                printf("[NÚCLEO 0] RSSI: %ld dBm\n", (long)(int32_t)msg->dados[0]);
+                registrar_telemetria(TEL_RSSI, (int32_t)msg->dados[0]);
+                continue;
+            case MSG_STATUS_WIFI:
+                if (protocolo_status_wifi(msg) > 2) {
+                    snprintf(mensagem_str, sizeof(mensagem_str),
+                             "Status inválido: %u (tentativa %u)",
+                             protocolo_status_wifi(msg), protocolo_tentativa_wifi(msg));
+                    linha_tempo_mostrar_oled("Status inválido.", 0, 3000);
+                    printf("%s\n", mensagem_str);
+                    continue;
+                }
+                registrar_telemetria(TEL_STATUS_WIFI, (int32_t)protocolo_status_wifi(msg));
+                break;
+            case MSG_PUB_ACK:
+                break;
+            default:
+                printf("[NÚCLEO 0] Mensagem de tipo desconhecido: %u\n", msg->tipo);
+                continue;
+        }
 
-    MensagemWiFi msg = {.tentativa = tentativa, .status = status};
-    if (!fila_inserir(&fila_wifi, msg)) {
-        ssd1306_draw_utf8_multiline(buffer_oled, 0, 0, "Fila cheia. Descartado.");
-        render_on_display(buffer_oled, &area);
-        sleep_ms(3000);
-        oled_clear(buffer_oled, &area);
-        render_on_display(buffer_oled, &area);
-        printf("Fila cheia. Mensagem descartada.\n");
+        tratar_mensagem(*msg);
     }
 }
 
-void tratar_fila(void) {
-    MensagemWiFi msg_recebida;
-    if (fila_remover(&fila_wifi, &msg_recebida)) {
-        tratar_mensagem(msg_recebida);
+// Acrescenta uma amostra {chave: valor} em CBOR ao lote de telemetria (enviado em um único PUBLISH)
+static void registrar_telemetria(ChaveTelemetria chave, int32_t valor) {
+    CborEscritor w;
+    if (mqtt_iniciado && lote_iniciar_registro(&w, TAM_REGISTRO_TELEMETRIA)) {
+        cbor_mapa(&w, 1);
+        cbor_u32(&w, chave);
+        cbor_i32(&w, valor);
+        lote_concluir_registro(&w);
     }
 }
 
+
+// Nova tentativa de iniciar o cliente MQTT (fila de comandos estava cheia)
+static int64_t alarme_inicio_mqtt_cb(alarm_id_t id, void *user_data) {
+    alarme_inicio_mqtt = 0;
+    eventos_sinalizar(EVT_FIFO);
+    return 0;
+}
+
 void inicializar_mqtt_se_preciso(void) {
     if (!mqtt_iniciado && ultimo_ip_bin != 0) {
         printf("[MQTT] Iniciando cliente MQTT...\n");
-        iniciar_mqtt_cliente();
+        // Cada etapa que não coube na fila de comandos é refeita pelo alarme
+        bool pronto = iniciar_mqtt_cliente() && comandos_inicializar();
+#ifndef MODO_BENCHMARK
+        pronto = pronto && rtt_ping_inicializar();
+#endif
+        if (!pronto) {
+            if (!alarme_inicio_mqtt) {
+                alarme_inicio_mqtt = add_alarm_in_ms(REDE_NOVA_SUBMISSAO_MS, alarme_inicio_mqtt_cb, NULL, true);
+            }
+            return;
+        }
         mqtt_iniciado = true;
-        proximo_envio = make_timeout_time_ms(INTERVALO_PING_MS);
+#ifdef MODO_BENCHMARK
+        benchmark_iniciar();
+#else
+        agendar_proximo_ping();
+#endif
+    }
+}
+
+// IRQ do DMA do OLED: o laço principal dispara o envio agrupado, se houver
+static void oled_concluido_cb(void) {
+    eventos_sinalizar(EVT_OLED);
+}
+
+// Alarme do alarm pool: apenas sinaliza o laço principal
+static int64_t alarme_ping_cb(alarm_id_t id, void *user_data) {
+    eventos_sinalizar(EVT_PING);
+    return 0;
+}
+
+static void agendar_proximo_ping(void) {
+    proximo_envio = make_timeout_time_ms(intervalo_ping_ms);
+    add_alarm_at(proximo_envio, alarme_ping_cb, NULL, true);
+}
+
+// Resumo do RTT do PING: publicado no lote de telemetria e exibido no OLED
+static void relatar_rtt(bool publicar) {
+    ResumoRtt rtt;
+    rtt_ping_resumo(&rtt);
+    if (rtt.recebidos == 0) {
+        return;
+    }
+
+    // Preenchido até 16 colunas para apagar o texto anterior da linha
+    char linha[24];
+    snprintf(linha, sizeof(linha), "RTT %lu.%lu/%lu.%lums        ",
+             (unsigned long)(rtt.p50_us / 1000), (unsigned long)(rtt.p50_us % 1000 / 100),
+             (unsigned long)(rtt.p99_us / 1000), (unsigned long)(rtt.p99_us % 1000 / 100));
+    linha[16] = '\0';
+    ssd1306_draw_utf8_multiline(buffer_oled, 0, 48, linha);
+
+    if (!publicar) {
+        return;
+    }
+    printf("[RTT] p50=%lu us p99=%lu us máx=%lu us | enviados=%lu recebidos=%lu perdidos=%lu "
+           "fora de ordem=%lu duplicados=%lu\n",
+           (unsigned long)rtt.p50_us, (unsigned long)rtt.p99_us, (unsigned long)rtt.max_us,
+           (unsigned long)rtt.enviados, (unsigned long)rtt.recebidos, (unsigned long)rtt.perdidos,
+           (unsigned long)rtt.fora_ordem, (unsigned long)rtt.duplicados);
+
+    CborEscritor w;
+    if (lote_iniciar_registro(&w, TAM_REGISTRO_RTT)) {
+        cbor_mapa(&w, 4);
+        cbor_u32(&w, TEL_RTT_P50_US);
+        cbor_u32(&w, rtt.p50_us);
+        cbor_u32(&w, TEL_RTT_P99_US);
+        cbor_u32(&w, rtt.p99_us);
+        cbor_u32(&w, TEL_PING_PERDIDOS);
+        cbor_u32(&w, rtt.perdidos);
+        cbor_u32(&w, TEL_PING_FORA_ORDEM);
+        cbor_u32(&w, rtt.fora_ordem);
+        lote_concluir_registro(&w);
     }
 }
 
 void enviar_ping_periodico(void) {
     if (mqtt_iniciado && absolute_time_diff_us(get_absolute_time(), proximo_envio) <= 0) {
-        publicar_mensagem_mqtt("PING");
-        ssd1306_draw_utf8_multiline(buffer_oled, 0, 0, "PING enviado...");
+        uint8_t payload[RTT_PING_TAM_PAYLOAD];
+        size_t tamanho = rtt_ping_codificar(payload, sizeof(payload));
+        if (publicar_ping(payload, tamanho)) {
+            ssd1306_draw_utf8_multiline(buffer_oled, 0, 0, "PING enviado...");
+        } else {
+            rtt_ping_cancelar();   // Offline: o PING não sai e não conta como perdido
+        }
+        agendar_proximo_ping();
+
+        bool relatorio = ++pings_enviados % PINGS_POR_RELATORIO == 0;
+        relatar_rtt(relatorio);
         render_on_display(buffer_oled, &area);
-        proximo_envio = make_timeout_time_ms(INTERVALO_PING_MS);
+
+        if (relatorio) {
+            eventos_imprimir_histograma();
+            printf("[CAIXA] Coalescidas: %lu, descartadas: %lu\n",
+                   (unsigned long)caixa_fifo.coalescidas, (unsigned long)caixa_fifo.descartadas);
+            EstatisticasOled oled;
+            ssd1306_estatisticas(&oled);
+            printf("[OLED] %lu renders (%lu agrupados), %lu janelas, %lu bytes (área inteira: %lu bytes), "
+                   "%lu transações (%lu endereçamentos evitados), %lu abortos\n",
+                   (unsigned long)oled.quadros, (unsigned long)oled.agrupados, (unsigned long)oled.janelas,
+                   (unsigned long)oled.bytes, (unsigned long)oled.bytes_quadro_inteiro,
+                   (unsigned long)oled.transacoes, (unsigned long)oled.enderecamentos_evitados,
+                   (unsigned long)oled.abortados);
+            mqtt_imprimir_estatisticas();
+        }
     }
 }
 
 /************/
 void inicia_hardware(){
     stdio_init_all();
-    setup_init_oled();
+#if BOOT_ESPERAR_USB
     espera_usb();
-    oled_clear(buffer_oled, &area);
-    render_on_display(buffer_oled, &area);
-    
+#endif
+
     srand(time(NULL));  // Inicializa gerador de números aleatórios padrão
 }
 
 void inicia_core1(){
-// Mensagem de inicialização
+    caixa_inicializar(&caixa_fifo);
+    protocolo_inicializar();
+    eventos_inicializar();
+    linha_tempo_inicializar();
+    nucleo_rede_inicializar();
+    multicore_launch_core1(funcao_wifi_nucleo1);
+    rastro_boot_marcar(BOOT_NUCLEO1);
+
+    printf(">> Núcleo 0 iniciado. Aguardando mensagens do núcleo 1...\n");
+}
+
+// OLED e PWM sobem enquanto o núcleo 1 associa; as mensagens dele esperam na caixa
+void inicia_perifericos(){
+    ssd1306_flush_ao_concluir(oled_concluido_cb);
+    setup_init_oled();
+    oled_clear(buffer_oled, &area);
+
+    // Mensagem de inicialização, apagada pela linha do tempo (sem bloquear o boot)
     ssd1306_draw_utf8_multiline(buffer_oled, 0, 0, "Núcleo 0");
     ssd1306_draw_utf8_multiline(buffer_oled, 0, 16, "Iniciando!");
     render_on_display(buffer_oled, &area);
-    sleep_ms(3000);
-    oled_clear(buffer_oled, &area);
-    render_on_display(buffer_oled, &area);
-
-    printf(">> Núcleo 0 iniciado. Aguardando mensagens do núcleo 1...\n");
+    linha_tempo_agendar_limpeza(BOOT_SPLASH_MS);
+    rastro_boot_marcar(BOOT_OLED);
 
     init_rgb_pwm();
-    fila_inicializar(&fila_wifi);
-    multicore_launch_core1(funcao_wifi_nucleo1);
+    rastro_boot_marcar(BOOT_PWM);
 }
\ No newline at end of file
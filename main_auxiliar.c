@@ -3,11 +3,12 @@
  * @brief Funções auxiliares do núcleo 0 no projeto multicore com Raspberry Pi Pico W.
  *
  * Este arquivo complementa a lógica do núcleo 0, com foco na visualização e interpretação
- * das mensagens trocadas entre os núcleos via FIFO. Ele oferece suporte ao sistema de
+ * das mensagens enviadas pelo núcleo 1 (`protocolo_nucleos.h`). Ele oferece suporte ao sistema de
  * exibição no display OLED e ao controle visual do estado da rede por meio de um LED RGB.
  */
 
 #include "fila_circular.h"
+#include "protocolo_nucleos.h"
 #include "rgb_pwm_control.h"
 #include "configura_geral.h"
 #include "oled_utils.h"
@@ -17,6 +18,7 @@
 #include "pico/multicore.h"
 #include <stdio.h>
 #include "estado_mqtt.h"
+#include "linha_tempo.h"
 
 /**
  * @brief Aguarda até que a conexão USB esteja pronta para comunicação.
@@ -29,21 +31,21 @@ void espera_usb() {
 }
 
 /**
- * @brief Trata mensagens recebidas pela FIFO — status Wi-Fi ou retorno de PING.
+ * @brief Trata mensagens recebidas do núcleo 1 — status Wi-Fi ou retorno de PING.
  *
- * - Status Wi-Fi (tentativa normal)
- * - Retorno de publicação PING (tentativa == 0x9999)
+ * - Status Wi-Fi (`MSG_STATUS_WIFI`)
+ * - Retorno de publicação PING (`MSG_PUB_ACK`)
  */
 
 int numero_aleatorio(int min, int max) {
     return (rand() % (max - min + 1)) + min;
 }
-void tratar_mensagem(MensagemWiFi msg) {
+void tratar_mensagem(MensagemNucleo msg) {
     const char *descricao = "";
 
     // ======= NOVA LÓGICA: resposta ao PING =======
-    if (msg.tentativa == 0x9999) {
-        if (msg.status == 0) {
+    if (msg.tipo == MSG_PUB_ACK) {
+        if ((int32_t)msg.dados[0] == 0) {
             // Gera uma cor aleatória (exceto verde)
             int cor = numero_aleatorio(0, 2);  // Resultado: 0, 1 ou 2
 
@@ -59,22 +61,21 @@ void tratar_mensagem(MensagemWiFi msg) {
                     break;
             }
 
-            sleep_ms(1000);  // Mantém a cor aleatória por 1 segundo
-
-            // Mensagem de ACK do PING OK
-            ssd1306_draw_utf8_multiline(buffer_oled, 0, 32, "ACK do PING OK");
-            set_rgb_pwm(0, 65535, 0);  // Volta para verde
+            // Mantém a cor aleatória por 1 segundo, depois mostra o ACK e volta para verde
+            linha_tempo_agendar_texto(1000, "ACK do PING OK", 32);
+            linha_tempo_agendar_led(1000, 0, 65535, 0);
         } else {
             ssd1306_draw_utf8_multiline(buffer_oled, 0, 32, "ACK do PING FALHOU");
             set_rgb_pwm(65535, 0, 0);  // Vermelho para falha
+            render_on_display(buffer_oled, &area);
         }
-
-        render_on_display(buffer_oled, &area);
         return;
     }
 
     // ======= STATUS Wi-Fi padrão =======
-    switch (msg.status) {
+    uint16_t tentativa = protocolo_tentativa_wifi(&msg);
+
+    switch (protocolo_status_wifi(&msg)) {
         case 0:
             descricao = "INICIALIZANDO";
             set_rgb_pwm(PWM_STEP, 0, 0);  // LED vermelho
@@ -96,13 +97,10 @@ void tratar_mensagem(MensagemWiFi msg) {
     char linha_status[32];
     snprintf(linha_status, sizeof(linha_status), "Status do Wi-Fi : %s", descricao);
 
-    ssd1306_draw_utf8_multiline(buffer_oled, 0, 0, linha_status);
-    render_on_display(buffer_oled, &area);
-    sleep_ms(3000);
-    oled_clear(buffer_oled, &area);
-    render_on_display(buffer_oled, &area);
+    // Exibe por 3 segundos sem bloquear; a limpeza fica agendada
+    linha_tempo_mostrar_oled(linha_status, 0, 3000);
 
-    printf("[NÚCLEO 0] Status: %s (%s)\n", descricao, msg.tentativa > 0 ? descricao : "evento");
+    printf("[NÚCLEO 0] Status: %s (%s)\n", descricao, tentativa > 0 ? descricao : "evento");
 }
 
 /**
@@ -124,6 +122,11 @@ void tratar_ip_binario(uint32_t ip_bin) {
     render_on_display(buffer_oled, &area);
 
     printf("[NÚCLEO 0] Endereço IP: %s\n", ip_str);
+
+    // IP após uma queda do Wi-Fi: o supervisor MQTT reconecta sem esperar o backoff
+    if (mqtt_iniciado) {
+        mqtt_notificar_novo_ip(ip_bin != ultimo_ip_bin);
+    }
     ultimo_ip_bin = ip_bin;
 }
 
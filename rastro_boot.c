@@ -0,0 +1,54 @@
+/**
+ * @file rastro_boot.c
+ * @brief Rastro das fases do boot.
+ *
+ * Os instantes são palavras de 32 bits (escrita atômica no RP2040), cada uma escrita por
+ * um único núcleo; 2^32 us cobrem os primeiros 71 minutos após o reset.
+ */
+
+#include "rastro_boot.h"
+#include "mqtt_lwip.h"
+#include "cbor_mini.h"
+#include "configura_geral.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+#define TAM_RASTRO (1 + BOOT_N_FASES * (1 + 5))   // Mapa CBOR {uint: u32} no pior caso
+
+static volatile uint32_t instantes_us[BOOT_N_FASES];
+static bool relatado = false;
+
+static const char *const nomes[BOOT_N_FASES] = {
+    "relógio", "núcleo 1", "OLED", "PWM", "enlace", "IP", "MQTT", "1ª publicação",
+};
+
+void rastro_boot_marcar(FaseBoot fase) {
+    if (!instantes_us[fase]) {
+        instantes_us[fase] = (uint32_t)time_us_64();
+    }
+}
+
+void rastro_boot_relatar(void) {
+    if (relatado || !instantes_us[BOOT_PRIMEIRA_PUB]) {
+        return;
+    }
+    relatado = true;
+
+    uint8_t payload[TAM_RASTRO];
+    CborEscritor w;
+    cbor_iniciar(&w, payload, sizeof(payload));
+    cbor_mapa(&w, BOOT_N_FASES);
+
+    printf("[BOOT]");
+    for (int i = 0; i < BOOT_N_FASES; i++) {
+        uint32_t us = instantes_us[i];
+        cbor_u32(&w, (uint32_t)i);
+        cbor_u32(&w, us);
+        printf(" %s %lu.%01lu ms%s", nomes[i], (unsigned long)(us / 1000),
+               (unsigned long)(us % 1000 / 100), i + 1 < BOOT_N_FASES ? "," : "\n");
+    }
+
+    if (cbor_ok(&w)) {
+        publicar_mqtt(TOPICO_BOOT, payload, cbor_tamanho(&w), MQTT_QOS_PADRAO, 1, PRIORIDADE_BAIXA);
+    }
+}
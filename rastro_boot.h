@@ -0,0 +1,31 @@
+/**
+ * @file rastro_boot.h
+ * @brief Instantes de cada fase do boot, marcados pelos dois núcleos e relatados via MQTT.
+ *
+ * Cada fase guarda o `time_us_64()` (desde o reset) da primeira vez em que foi marcada.
+ * Quando a primeira publicação é confirmada, o núcleo 0 publica o rastro em
+ * `TOPICO_BOOT` como um mapa CBOR {fase: instante_us}, com retain, e o imprime no terminal.
+ */
+
+#ifndef RASTRO_BOOT_H
+#define RASTRO_BOOT_H
+
+typedef enum {
+    BOOT_RELOGIO = 0,     // Entrada em main(): clocks e runtime do SDK prontos
+    BOOT_NUCLEO1,         // Núcleo 1 lançado (Wi-Fi começa em paralelo)
+    BOOT_OLED,            // Display inicializado e splash desenhado
+    BOOT_PWM,             // LED RGB pronto
+    BOOT_ENLACE,          // Associado ao ponto de acesso (núcleo 1)
+    BOOT_IP,              // Endereço IP obtido (núcleo 1)
+    BOOT_MQTT,            // CONNACK aceito
+    BOOT_PRIMEIRA_PUB,    // Primeira publicação confirmada (PUBACK no QoS 1, envio no QoS 0)
+    BOOT_N_FASES
+} FaseBoot;
+
+// Qualquer núcleo; apenas a primeira marcação de cada fase é mantida
+void rastro_boot_marcar(FaseBoot fase);
+
+// Núcleo 0, em EVT_MQTT: publica o rastro uma única vez, após a primeira publicação
+void rastro_boot_relatar(void);
+
+#endif
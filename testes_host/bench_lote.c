@@ -0,0 +1,143 @@
+/**
+ * @file bench_lote.c
+ * @brief Telemetria com e sem lote contra um broker local (mosquitto).
+ *
+ *   bench_lote [host] [porta] [amostras]
+ *
+ * As mesmas amostras (mapas CBOR {chave: int32}, como `registrar_telemetria()` no
+ * firmware) são publicadas uma por PUBLISH e depois agrupadas por `lote_telemetria.c`,
+ * passando pela fila de saída e pelo controle de taxa do firmware. Uma linha JSON por
+ * modo, por exemplo:
+ *
+ *   {"bench":"lote","modo":"lote","amostras":500,"publicacoes":12,"segmentos":12,
+ *    "bytes_mqtt":2650,"bytes_ip":3130,"pacotes_s":...,"amostras_s":...}
+ *
+ * `segmentos` são os segmentos TCP com dados contados pelo kernel; `bytes_ip` soma 40
+ * bytes de cabeçalho IPv4 + TCP por segmento (a lwIP não usa opções de timestamp).
+ * Sem lote, a vazão fica presa ao controle de taxa (`CONTROLE_TAXA_*`), como no firmware.
+ * Sem broker, termina com o código 77 (teste pulado no CTest); publicações que não são
+ * confirmadas no prazo fazem o teste falhar, mesmo no primeiro caso.
+ */
+
+#include "rede_host.h"
+#include "lote_telemetria.h"
+#include "cbor_mini.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define AMOSTRAS_PADRAO 500
+#define TAM_REGISTRO 8            // Mesmo limite de main.c: 1 + 1 + 5 bytes no pior caso
+#define CABECALHO_IP_TCP 40
+#define DRENO_MAX_MS 10000
+
+// Espera espaço na fila de saída, como o firmware ao respeitar a profundidade; false se
+// nenhuma confirmação liberou espaço em DRENO_MAX_MS
+static bool aguardar_espaco(void) {
+    absolute_time_t limite = make_timeout_time_ms(DRENO_MAX_MS);
+    while (rede_host_profundidade() >= MQTT_FILA_PUB_TAM) {
+        if (time_reached(limite)) {
+            return false;
+        }
+        rede_host_processar(1000);
+    }
+    return true;
+}
+
+static int32_t valor_amostra(uint32_t i) {
+    return -40 - (int32_t)(i % 50);   // RSSI plausível
+}
+
+static bool enviar_sem_lote(uint32_t amostras) {
+    for (uint32_t i = 0; i < amostras; i++) {
+        uint8_t registro[TAM_REGISTRO];
+        CborEscritor w;
+        cbor_iniciar(&w, registro, sizeof(registro));
+        cbor_mapa(&w, 1);
+        cbor_u32(&w, TEL_RSSI);
+        cbor_i32(&w, valor_amostra(i));
+
+        if (!aguardar_espaco()) {
+            return false;
+        }
+        publicar_mqtt(TOPICO_TELEMETRIA, registro, cbor_tamanho(&w), MQTT_QOS_PADRAO, 0, PRIORIDADE_BAIXA);
+        rede_host_processar(0);
+    }
+    return true;
+}
+
+static bool enviar_com_lote(uint32_t amostras) {
+    lote_inicializar(TOPICO_TELEMETRIA);
+    for (uint32_t i = 0; i < amostras; i++) {
+        CborEscritor w;
+        if (!aguardar_espaco()) {   // O lote pode ser descarregado ao abrir o registro
+            return false;
+        }
+        if (lote_iniciar_registro(&w, TAM_REGISTRO)) {
+            cbor_mapa(&w, 1);
+            cbor_u32(&w, TEL_RSSI);
+            cbor_i32(&w, valor_amostra(i));
+            lote_concluir_registro(&w);
+        }
+        rede_host_processar(0);
+    }
+    if (!aguardar_espaco()) {
+        return false;
+    }
+    lote_descarregar();
+    return true;
+}
+
+static ResultadoMedicao medir(const char *modo, bool com_lote, uint32_t amostras, const char *host,
+                              uint16_t porta) {
+    if (!rede_host_conectar(host, porta, NULL)) {
+        return MEDICAO_SEM_BROKER;
+    }
+
+    uint64_t t0 = time_us_64();
+    bool enviou = com_lote ? enviar_com_lote(amostras) : enviar_sem_lote(amostras);
+    bool drenou = enviou && rede_host_drenar(DRENO_MAX_MS);
+    double segundos = (double)(time_us_64() - t0) / 1e6;
+
+    EstatisticasMqttHost antes_desconectar;
+    EstatisticasPublicacao fila;
+    rede_host_estatisticas(&antes_desconectar);
+    fila_publicacao_estatisticas(&fila);
+    rede_host_desconectar();
+
+    printf("{\"bench\":\"lote\",\"modo\":\"%s\",\"amostras\":%u,\"publicacoes\":%u,\"confirmadas\":%u,"
+           "\"segmentos\":%u,\"bytes_mqtt\":%llu,\"bytes_ip\":%llu,\"bytes_ip_amostra\":%.1f,"
+           "\"pacotes_s\":%.1f,\"amostras_s\":%.1f,\"segundos\":%.2f,\"drenou\":%s}\n",
+           modo, amostras, antes_desconectar.publicacoes, fila.confirmadas, antes_desconectar.segmentos,
+           (unsigned long long)antes_desconectar.bytes_mqtt,
+           (unsigned long long)(antes_desconectar.bytes_mqtt +
+                                (uint64_t)antes_desconectar.segmentos * CABECALHO_IP_TCP),
+           (double)(antes_desconectar.bytes_mqtt + (uint64_t)antes_desconectar.segmentos * CABECALHO_IP_TCP) /
+               amostras,
+           antes_desconectar.segmentos / segundos, amostras / segundos, segundos, drenou ? "true" : "false");
+    return drenou ? MEDICAO_OK : MEDICAO_SEM_CONFIRMACOES;
+}
+
+int main(int argc, char **argv) {
+    const char *host;
+    uint16_t porta;
+    rede_host_broker(argc, argv, &host, &porta);
+    uint32_t amostras = argc > 3 ? (uint32_t)atoi(argv[3]) : AMOSTRAS_PADRAO;
+
+    ResultadoMedicao r = medir("sem_lote", false, amostras, host, porta);
+    if (r == MEDICAO_OK) {
+        // O broker respondeu na primeira medição: perdê-lo agora é falha, não teste pulado
+        r = medir("lote", true, amostras, host, porta);
+        if (r == MEDICAO_SEM_BROKER) {
+            r = MEDICAO_SEM_CONFIRMACOES;
+        }
+    }
+    if (r == MEDICAO_SEM_BROKER) {
+        fprintf(stderr, "Broker %s:%u indisponível\n", host, porta);
+        return CODIGO_SEM_BROKER;
+    }
+    if (r == MEDICAO_SEM_CONFIRMACOES) {
+        fprintf(stderr, "Publicações sem confirmação após %u ms ou broker perdido\n", DRENO_MAX_MS);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file bench_mqtt.c
+ * @brief Varredura de carga do caminho de publicação contra um broker local (mosquitto).
+ *
+ *   bench_mqtt [host] [porta] [duracao_ms]
+ *
+ * Os mesmos casos do modo de benchmark do firmware (`benchmark.c`): tamanho do registro,
+ * registros por PUBLISH (no enquadramento de `lote_telemetria.h`), QoS e taxa de envio.
+ * Cada caso passa pela fila de saída do firmware e imprime uma linha JSON com as chaves
+ * do firmware, mais o tempo de CPU do processo:
+ *
+ *   {"bench":"mqtt_pub","plataforma":"host","payload":48,"lote":4,"qos":1,"taxa":200,
+ *    "enviados":400,"recusados":0,"confirmados":400,"msgs_s":...,"registros_s":...,
+ *    "p50_us":...,"p99_us":...,"cpu_us_msg":...,"cpu_processo_us_msg":...}
+ *
+ * `cpu_us_msg` é o tempo para codificar e enfileirar, como no firmware;
+ * `cpu_processo_us_msg` divide a CPU do processo (`CLOCK_PROCESS_CPUTIME_ID`) no caso
+ * inteiro, incluindo os sockets, pelas mensagens confirmadas. Como no firmware, a vazão
+ * fica presa ao controle de taxa (`CONTROLE_TAXA_*`), cujas mensagens `[TAXA]` também
+ * saem na saída padrão: as linhas de resultado são as que começam com `{`.
+ * Sem broker, termina com o código 77 (teste pulado no CTest); publicações que não são
+ * confirmadas no prazo fazem o teste falhar, mesmo no primeiro caso.
+ */
+
+#include "rede_host.h"
+#include "benchmark.h"
+#include "lote_telemetria.h"
+#include "histograma_hdr.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TICK_LIVRE_US 1000   // Espera após a fila recusar, na taxa ilimitada
+
+static const uint16_t tamanhos[] = { 16, 48, 200 };   // Por registro; 200 × 4 não cabe e é pulado
+static const uint8_t lotes[] = { 1, 4 };
+static const uint8_t qos_casos[] = { 0, 1 };
+static const uint16_t taxas[] = { 50, 200, 0 };   // msgs/s; 0 = o máximo que a fila aceitar
+
+static uint8_t payload[MQTT_TAM_PAYLOAD];
+static HistogramaHdr latencias;
+
+static uint64_t cpu_processo_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+// Mesmo enquadramento de benchmark.c; 0 se o caso não couber no payload máximo
+static uint16_t montar_payload(uint16_t tamanho, uint8_t lote) {
+    uint32_t total = lote == 1 ? tamanho : 2 + (uint32_t)lote * (1 + tamanho);
+    if (total > MQTT_TAM_PAYLOAD) {
+        return 0;
+    }
+
+    memset(payload, 0x5A, sizeof(payload));
+    if (lote > 1) {
+        payload[0] = LOTE_VERSAO;
+        payload[1] = lote;
+        for (uint32_t i = 0; i < lote; i++) {
+            payload[2 + i * (1 + tamanho)] = (uint8_t)tamanho;
+        }
+    }
+    return (uint16_t)total;
+}
+
+static ResultadoMedicao medir_caso(uint16_t tamanho, uint8_t lote, uint8_t qos, uint16_t taxa,
+                                   uint32_t duracao_ms, const char *host, uint16_t porta) {
+    uint16_t tam_payload = montar_payload(tamanho, lote);
+    if (!tam_payload) {
+        return MEDICAO_OK;
+    }
+    if (!rede_host_conectar(host, porta, NULL)) {
+        return MEDICAO_SEM_BROKER;
+    }
+    hdr_zerar(&latencias);
+    fila_publicacao_medir_latencias(&latencias);
+
+    uint32_t enviados = 0, recusados = 0;
+    uint64_t cpu_fila_us = 0;
+    uint64_t cpu_inicio = cpu_processo_us();
+    uint64_t inicio_us = time_us_64();
+    uint64_t fim_us = inicio_us + (uint64_t)duracao_ms * 1000;
+    uint64_t proximo_us = inicio_us;
+
+    while (time_us_64() < fim_us) {
+        if (taxa && time_us_64() < proximo_us) {
+            rede_host_processar((uint32_t)(proximo_us - time_us_64()));
+            continue;
+        }
+        uint64_t t0 = time_us_64();
+        bool aceita = mqtt_enfileirar(BENCHMARK_TOPICO, payload, tam_payload, qos, 0, PRIORIDADE_ALTA);
+        cpu_fila_us += time_us_64() - t0;
+        if (aceita) {
+            enviados++;
+        } else {
+            recusados++;
+        }
+        if (taxa) {
+            proximo_us += 1000000u / taxa;
+        }
+        rede_host_processar(aceita ? 0 : TICK_LIVRE_US);
+    }
+    bool drenou = rede_host_drenar(BENCHMARK_DRENO_MS);
+
+    EstatisticasPublicacao fila;
+    fila_publicacao_estatisticas(&fila);
+    uint64_t duracao_us = time_us_64() - inicio_us;
+    uint64_t cpu_us = cpu_processo_us() - cpu_inicio;
+    fila_publicacao_medir_latencias(NULL);
+    rede_host_desconectar();
+
+    printf("{\"bench\":\"mqtt_pub\",\"plataforma\":\"host\",\"payload\":%u,\"lote\":%u,\"qos\":%u,"
+           "\"taxa\":%u,\"enviados\":%u,\"recusados\":%u,\"confirmados\":%u,"
+           "\"msgs_s\":%.1f,\"registros_s\":%.1f,\"p50_us\":%u,\"p99_us\":%u,"
+           "\"cpu_us_msg\":%.2f,\"cpu_processo_us_msg\":%.2f,\"drenou\":%s}\n",
+           tamanho, lote, qos, taxa, enviados, recusados, fila.confirmadas,
+           fila.confirmadas * 1e6 / duracao_us, fila.confirmadas * lote * 1e6 / duracao_us,
+           hdr_percentil(&latencias, 500), hdr_percentil(&latencias, 990),
+           enviados ? (double)cpu_fila_us / enviados : 0.0,
+           fila.confirmadas ? (double)cpu_us / fila.confirmadas : 0.0,
+           drenou ? "true" : "false");
+    fflush(stdout);
+    return drenou ? MEDICAO_OK : MEDICAO_SEM_CONFIRMACOES;
+}
+
+int main(int argc, char **argv) {
+    const char *host;
+    uint16_t porta;
+    rede_host_broker(argc, argv, &host, &porta);
+    uint32_t duracao_ms = argc > 3 ? (uint32_t)atoi(argv[3]) : BENCHMARK_DURACAO_MS;
+
+    // Broker ausente só pulado se nenhum caso chegou a conectar; queda no meio é falha
+    bool conectou = false, falhou = false;
+    for (size_t t = 0; t < count_of(tamanhos); t++) {
+        for (size_t l = 0; l < count_of(lotes); l++) {
+            for (size_t q = 0; q < count_of(qos_casos); q++) {
+                for (size_t x = 0; x < count_of(taxas); x++) {
+                    ResultadoMedicao r = medir_caso(tamanhos[t], lotes[l], qos_casos[q], taxas[x],
+                                                    duracao_ms, host, porta);
+                    if (r == MEDICAO_SEM_BROKER && !conectou) {
+                        fprintf(stderr, "Broker %s:%u indisponível\n", host, porta);
+                        return CODIGO_SEM_BROKER;
+                    }
+                    if (r == MEDICAO_SEM_CONFIRMACOES) {
+                        fprintf(stderr, "Caso payload=%u lote=%u qos=%u taxa=%u sem confirmações\n",
+                                tamanhos[t], lotes[l], qos_casos[q], taxas[x]);
+                    }
+                    conectou = true;
+                    falhou = falhou || r != MEDICAO_OK;
+                }
+            }
+        }
+    }
+    return falhou ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,18 @@
+/**
+ * @file altcp.h
+ * @brief Conexão TCP do cliente MQTT do host (`mqtt_host.c`).
+ */
+
+#ifndef LWIP_HOST_ALTCP_H
+#define LWIP_HOST_ALTCP_H
+
+#include <stdint.h>
+
+struct altcp_pcb {
+    int fd;
+};
+
+// Espaço livre no buffer de envio, na escala de TCP_SND_BUF (SIOCOUTQ do socket)
+uint16_t altcp_sndbuf(struct altcp_pcb *conn);
+
+#endif
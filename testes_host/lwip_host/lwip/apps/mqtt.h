@@ -0,0 +1,46 @@
+/**
+ * @file mqtt.h
+ * @brief Subconjunto da API MQTT da lwIP sobre um socket TCP do host (`mqtt_host.c`).
+ *
+ * Implementa o que a fila de saída usa (`mqtt_publish()` e `mqtt_client_is_connected()`)
+ * com a mesma semântica: no máximo `MQTT_REQ_MAX_IN_FLIGHT` requisições pendentes
+ * (ERR_MEM além disso), callback no PUBACK (QoS 1) ou após o envio (QoS 0) e
+ * ERR_TIMEOUT após `MQTT_REQ_TIMEOUT` segundos. Os callbacks só rodam dentro de
+ * `mqtt_host_processar()`, como a lwIP, que nunca os chama de dentro de `mqtt_publish()`.
+ */
+
+#ifndef LWIP_HOST_MQTT_H
+#define LWIP_HOST_MQTT_H
+
+#include "lwip/err.h"
+#include "lwip/opt.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct mqtt_client_s mqtt_client_t;
+typedef void (*mqtt_request_cb_t)(void *arg, err_t result);
+
+err_t mqtt_publish(mqtt_client_t *client, const char *topic, const void *payload, uint16_t payload_length,
+                   uint8_t qos, uint8_t retain, mqtt_request_cb_t cb, void *arg);
+uint8_t mqtt_client_is_connected(mqtt_client_t *client);
+
+// ========================
+// SÓ NO HOST
+// ========================
+
+typedef struct {
+    uint32_t publicacoes;        // PUBLISH escritos no socket
+    uint64_t bytes_mqtt;         // Bytes MQTT escritos (todos os pacotes, inclusive CONNECT)
+    uint32_t segmentos;          // Segmentos TCP com dados (tcpi_data_segs_out)
+} EstatisticasMqttHost;
+
+// Conecta ao broker (CONNECT com sessão limpa) e espera o CONNACK; NULL em falha
+mqtt_client_t *mqtt_host_conectar(const char *host, uint16_t porta, const char *client_id);
+void mqtt_host_desconectar(mqtt_client_t *client);
+
+// Lê PUBACKs e conclui requisições, esperando até `espera_us` por dados do broker
+void mqtt_host_processar(mqtt_client_t *client, uint32_t espera_us);
+
+void mqtt_host_estatisticas(mqtt_client_t *client, EstatisticasMqttHost *est);
+
+#endif
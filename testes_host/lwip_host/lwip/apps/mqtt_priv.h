@@ -0,0 +1,36 @@
+/**
+ * @file mqtt_priv.h
+ * @brief Estrutura do cliente MQTT do host, com os campos que `controle_taxa.c` consulta.
+ */
+
+#ifndef LWIP_HOST_MQTT_PRIV_H
+#define LWIP_HOST_MQTT_PRIV_H
+
+#include "lwip/apps/mqtt.h"
+#include "lwip/altcp.h"
+
+typedef struct {
+    uint16_t pkt_id;             // 0 no QoS 0
+    bool ativa;
+    bool enviada_qos0;           // QoS 0: conclui na próxima passada de mqtt_host_processar()
+    uint64_t instante_us;
+    mqtt_request_cb_t cb;
+    void *arg;
+} RequisicaoMqttHost;
+
+struct mqtt_client_s {
+    struct {
+        uint16_t put;            // O socket aceita tudo na hora: o anel fica sempre vazio
+        uint16_t get;
+    } output;
+    struct altcp_pcb *conn;
+    struct altcp_pcb pcb;
+    bool conectado;
+    uint16_t proximo_pkt_id;
+    RequisicaoMqttHost req[MQTT_REQ_MAX_IN_FLIGHT];
+    uint8_t rx[512];
+    uint32_t rx_ocupado;
+    EstatisticasMqttHost est;
+};
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @file opt.h
+ * @brief Opções da lwIP no host: as mesmas de `WIFI_/lwipopts.h`.
+ */
+
+#ifndef LWIP_HOST_OPT_H
+#define LWIP_HOST_OPT_H
+
+#include "lwipopts.h"
+
+#ifndef MQTT_REQ_TIMEOUT
+#define MQTT_REQ_TIMEOUT 30   // s, padrão da lwIP
+#endif
+
+#endif
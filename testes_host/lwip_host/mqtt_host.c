@@ -0,0 +1,271 @@
+/**
+ * @file mqtt_host.c
+ * @brief Cliente MQTT 3.1.1 mínimo sobre sockets do host, com a API da lwIP.
+ *
+ * Com `TCP_NODELAY`, cada PUBLISH sai em um segmento próprio, como na lwIP com o
+ * broker na rede local; os segmentos são contados pelo kernel (`TCP_INFO`).
+ */
+
+#include "lwip/apps/mqtt_priv.h"
+#include "pico/time.h"
+#include <linux/sockios.h>
+#include <linux/tcp.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define MQTT_TIPO_CONNECT  0x10
+#define MQTT_TIPO_CONNACK  0x20
+#define MQTT_TIPO_PUBLISH  0x30
+#define MQTT_TIPO_PUBACK   0x40
+#define MQTT_TIPO_DISCONNECT 0xE0
+#define MQTT_KEEP_ALIVE_HOST 60
+
+static bool escrever(mqtt_client_t *c, const uint8_t *dados, size_t tam) {
+    while (tam) {
+        ssize_t n = send(c->pcb.fd, dados, tam, MSG_NOSIGNAL);
+        if (n <= 0) {
+            c->conectado = false;
+            return false;
+        }
+        dados += n;
+        tam -= (size_t)n;
+        c->est.bytes_mqtt += (uint64_t)n;
+    }
+    return true;
+}
+
+// Comprimento restante (varint de até 4 bytes); devolve os bytes usados
+static size_t codificar_comprimento(uint8_t *saida, uint32_t comprimento) {
+    size_t n = 0;
+    do {
+        uint8_t b = comprimento & 0x7F;
+        comprimento >>= 7;
+        saida[n++] = b | (comprimento ? 0x80 : 0);
+    } while (comprimento);
+    return n;
+}
+
+static bool ler_exato(int fd, uint8_t *dados, size_t tam) {
+    while (tam) {
+        ssize_t n = recv(fd, dados, tam, 0);
+        if (n <= 0) {
+            return false;
+        }
+        dados += n;
+        tam -= (size_t)n;
+    }
+    return true;
+}
+
+mqtt_client_t *mqtt_host_conectar(const char *host, uint16_t porta, const char *client_id) {
+    struct addrinfo dicas = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM}, *res;
+    char servico[8];
+    snprintf(servico, sizeof(servico), "%u", porta);
+    if (getaddrinfo(host, servico, &dicas, &res) != 0) {
+        return NULL;
+    }
+
+    int fd = -1;
+    for (struct addrinfo *a = res; a; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+            break;
+        }
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if (fd < 0) {
+        return NULL;
+    }
+    int um = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &um, sizeof(um));
+
+    mqtt_client_t *c = calloc(1, sizeof(mqtt_client_t));
+    c->pcb.fd = fd;
+    c->conn = &c->pcb;
+    c->proximo_pkt_id = 1;
+
+    // CONNECT: protocolo "MQTT" nível 4, sessão limpa
+    uint8_t pacote[64];
+    size_t tam_id = strlen(client_id);
+    if (tam_id > sizeof(pacote) - 16) {
+        tam_id = sizeof(pacote) - 16;
+    }
+    size_t n = 0;
+    pacote[n++] = MQTT_TIPO_CONNECT;
+    pacote[n++] = (uint8_t)(10 + 2 + tam_id);
+    memcpy(&pacote[n], "\x00\x04MQTT\x04\x02", 8);
+    n += 8;
+    pacote[n++] = 0;
+    pacote[n++] = MQTT_KEEP_ALIVE_HOST;
+    pacote[n++] = 0;
+    pacote[n++] = (uint8_t)tam_id;
+    memcpy(&pacote[n], client_id, tam_id);
+    n += tam_id;
+
+    uint8_t connack[4];
+    c->conectado = true;
+    if (!escrever(c, pacote, n) || !ler_exato(fd, connack, sizeof(connack)) ||
+        connack[0] != MQTT_TIPO_CONNACK || connack[3] != 0) {
+        close(fd);
+        free(c);
+        return NULL;
+    }
+    return c;
+}
+
+void mqtt_host_desconectar(mqtt_client_t *c) {
+    const uint8_t disconnect[2] = {MQTT_TIPO_DISCONNECT, 0};
+    if (c->conectado) {
+        escrever(c, disconnect, sizeof(disconnect));
+    }
+    close(c->pcb.fd);
+    free(c);
+}
+
+uint8_t mqtt_client_is_connected(mqtt_client_t *client) {
+    return client && client->conectado;
+}
+
+uint16_t altcp_sndbuf(struct altcp_pcb *conn) {
+    int na_fila = 0;
+    ioctl(conn->fd, SIOCOUTQ, &na_fila);
+    return na_fila >= TCP_SND_BUF ? 0 : (uint16_t)(TCP_SND_BUF - na_fila);
+}
+
+err_t mqtt_publish(mqtt_client_t *c, const char *topic, const void *payload, uint16_t payload_length,
+                   uint8_t qos, uint8_t retain, mqtt_request_cb_t cb, void *arg) {
+    if (!c->conectado) {
+        return ERR_CONN;
+    }
+
+    RequisicaoMqttHost *r = NULL;
+    for (int i = 0; i < MQTT_REQ_MAX_IN_FLIGHT; i++) {
+        if (!c->req[i].ativa) {
+            r = &c->req[i];
+            break;
+        }
+    }
+    if (!r) {
+        return ERR_MEM;
+    }
+
+    uint16_t tam_topico = (uint16_t)strlen(topic);
+    uint32_t restante = 2u + tam_topico + (qos ? 2u : 0u) + payload_length;
+    uint8_t cabecalho[8 + 2 + 65535];
+    size_t n = 0;
+    cabecalho[n++] = MQTT_TIPO_PUBLISH | (uint8_t)(qos << 1) | (retain ? 1 : 0);
+    n += codificar_comprimento(&cabecalho[n], restante);
+    cabecalho[n++] = (uint8_t)(tam_topico >> 8);
+    cabecalho[n++] = (uint8_t)tam_topico;
+    memcpy(&cabecalho[n], topic, tam_topico);
+    n += tam_topico;
+
+    uint16_t pkt_id = 0;
+    if (qos) {
+        pkt_id = c->proximo_pkt_id++;
+        if (c->proximo_pkt_id == 0) {
+            c->proximo_pkt_id = 1;
+        }
+        cabecalho[n++] = (uint8_t)(pkt_id >> 8);
+        cabecalho[n++] = (uint8_t)pkt_id;
+    }
+    memcpy(&cabecalho[n], payload, payload_length);
+    n += payload_length;
+
+    if (!escrever(c, cabecalho, n)) {
+        return ERR_CONN;
+    }
+    c->est.publicacoes++;
+    *r = (RequisicaoMqttHost){pkt_id, true, qos == 0, time_us_64(), cb, arg};
+    return ERR_OK;
+}
+
+static void concluir(RequisicaoMqttHost *r, err_t resultado) {
+    r->ativa = false;
+    if (r->cb) {
+        r->cb(r->arg, resultado);
+    }
+}
+
+// Trata os pacotes completos do buffer de recepção; só o PUBACK interessa à fila
+static void tratar_recebidos(mqtt_client_t *c) {
+    uint32_t pos = 0;
+    while (pos + 2 <= c->rx_ocupado) {
+        uint32_t comprimento = 0, mult = 1, i = pos + 1;
+        bool completo_cab = false;
+        while (i < c->rx_ocupado && i < pos + 5) {
+            comprimento += (c->rx[i] & 0x7Fu) * mult;
+            mult <<= 7;
+            if (!(c->rx[i++] & 0x80)) {
+                completo_cab = true;
+                break;
+            }
+        }
+        if (!completo_cab || i + comprimento > c->rx_ocupado) {
+            break;
+        }
+
+        if ((c->rx[pos] & 0xF0) == MQTT_TIPO_PUBACK && comprimento >= 2) {
+            uint16_t pkt_id = (uint16_t)(c->rx[i] << 8 | c->rx[i + 1]);
+            for (int k = 0; k < MQTT_REQ_MAX_IN_FLIGHT; k++) {
+                if (c->req[k].ativa && !c->req[k].enviada_qos0 && c->req[k].pkt_id == pkt_id) {
+                    concluir(&c->req[k], ERR_OK);
+                    break;
+                }
+            }
+        }
+        pos = i + comprimento;
+    }
+    memmove(c->rx, &c->rx[pos], c->rx_ocupado - pos);
+    c->rx_ocupado -= pos;
+}
+
+void mqtt_host_processar(mqtt_client_t *c, uint32_t espera_us) {
+    uint64_t agora = time_us_64();
+    bool concluiu = false;
+    for (int i = 0; i < MQTT_REQ_MAX_IN_FLIGHT; i++) {
+        RequisicaoMqttHost *r = &c->req[i];
+        if (r->ativa && r->enviada_qos0) {
+            concluir(r, ERR_OK);
+            concluiu = true;
+        } else if (r->ativa && agora - r->instante_us >= MQTT_REQ_TIMEOUT * 1000000ull) {
+            concluir(r, ERR_TIMEOUT);
+            concluiu = true;
+        }
+    }
+
+    struct pollfd p = {.fd = c->pcb.fd, .events = POLLIN};
+    int espera_ms = concluiu ? 0 : (int)((espera_us + 999) / 1000);
+    if (!c->conectado || poll(&p, 1, espera_ms) <= 0) {
+        return;
+    }
+
+    ssize_t n = recv(c->pcb.fd, &c->rx[c->rx_ocupado], sizeof(c->rx) - c->rx_ocupado, MSG_DONTWAIT);
+    if (n <= 0) {
+        // Como a lwIP ao fechar a conexão: as requisições pendentes são descartadas sem callback
+        c->conectado = false;
+        memset(c->req, 0, sizeof(c->req));
+        return;
+    }
+    c->rx_ocupado += (uint32_t)n;
+    tratar_recebidos(c);
+}
+
+void mqtt_host_estatisticas(mqtt_client_t *c, EstatisticasMqttHost *est) {
+    struct tcp_info info;
+    socklen_t tam = sizeof(info);
+    *est = c->est;
+    if (getsockopt(c->pcb.fd, IPPROTO_TCP, TCP_INFO, &info, &tam) == 0) {
+        est->segmentos = info.tcpi_data_segs_out;
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file rede_host.c
+ * @brief Implementação do caminho de publicação no host (ver `rede_host.h`).
+ */
+
+#include "rede_host.h"
+#include "eventos.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static mqtt_client_t *cliente = NULL;
+
+bool rede_host_conectar(const char *host, uint16_t porta, ResultadoPublicacaoCb notificar) {
+    char client_id[24];
+    snprintf(client_id, sizeof(client_id), "pico_host_%d", (int)getpid());
+    cliente = mqtt_host_conectar(host, porta, client_id);
+    if (!cliente) {
+        return false;
+    }
+    fila_publicacao_inicializar(notificar);
+    return true;
+}
+
+void rede_host_desconectar(void) {
+    if (cliente) {
+        mqtt_host_desconectar(cliente);
+        cliente = NULL;
+    }
+}
+
+void rede_host_processar(uint32_t espera_us) {
+    sdk_host_processar_alarmes();
+    mqtt_host_processar(cliente, espera_us);
+    fila_publicacao_bombear(cliente);
+}
+
+uint32_t rede_host_profundidade(void) {
+    EstatisticasPublicacao est;
+    fila_publicacao_estatisticas(&est);
+    return est.profundidade;
+}
+
+bool rede_host_drenar(uint32_t limite_ms) {
+    absolute_time_t limite = make_timeout_time_ms(limite_ms);
+    while (rede_host_profundidade() > 0) {
+        if (time_reached(limite) || !mqtt_client_is_connected(cliente)) {
+            return false;
+        }
+        rede_host_processar(1000);
+    }
+    return true;
+}
+
+void rede_host_estatisticas(EstatisticasMqttHost *est) {
+    mqtt_host_estatisticas(cliente, est);
+}
+
+void rede_host_broker(int argc, char **argv, const char **host, uint16_t *porta) {
+    *host = argc > 1 ? argv[1] : "127.0.0.1";
+    *porta = argc > 2 ? (uint16_t)atoi(argv[2]) : 1883;
+}
+
+// ========================
+// API DE mqtt_lwip.h USADA PELOS MÓDULOS DO FIRMWARE
+// ========================
+
+bool mqtt_enfileirar(const char *topico, const void *dados, uint16_t tamanho, uint8_t qos, uint8_t retain,
+                     PrioridadePublicacao prioridade) {
+    bool aceita = fila_publicacao_enfileirar(topico, dados, tamanho, qos, retain, prioridade, PUB_TIPO_DADOS);
+    fila_publicacao_bombear(cliente);
+    return aceita;
+}
+
+bool publicar_mqtt(const char *topico, const void *dados, uint16_t tamanho, uint8_t qos, uint8_t retain,
+                   PrioridadePublicacao prioridade) {
+    return mqtt_enfileirar(topico, dados, tamanho, qos, retain, prioridade);
+}
+
+bool mqtt_esta_conectado(void) {
+    return mqtt_client_is_connected(cliente);
+}
+
+// Sem alarmes de hardware nem segundo núcleo: o laço de rede_host_processar() faz o trabalho
+void nucleo_rede_sinalizar(void) {
+}
+
+void eventos_sinalizar(uint32_t mascara) {
+}
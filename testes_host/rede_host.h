@@ -0,0 +1,44 @@
+/**
+ * @file rede_host.h
+ * @brief Caminho de publicação do firmware ligado ao cliente MQTT do host.
+ *
+ * Substitui `mqtt_lwip.c` e `nucleo_rede.c` nos benchmarks: `publicar_mqtt()` e
+ * `mqtt_enfileirar()` entram direto na fila de saída (`fila_publicacao.c`), como no
+ * arranjo sem `REDE_NUCLEO_UNICO`. Não há registro em flash: sem espaço na fila, a
+ * publicação é recusada.
+ */
+
+#ifndef REDE_HOST_H
+#define REDE_HOST_H
+
+#include "mqtt_lwip.h"
+#include "fila_publicacao.h"
+
+// Conecta ao broker e prepara a fila de saída; false se o broker não respondeu
+bool rede_host_conectar(const char *host, uint16_t porta, ResultadoPublicacaoCb notificar);
+void rede_host_desconectar(void);
+
+// Uma passada do "laço": alarmes vencidos, PUBACKs recebidos e bombeamento da fila
+void rede_host_processar(uint32_t espera_us);
+
+// Processa até a fila de saída esvaziar ou `limite_ms` passar; false no limite
+bool rede_host_drenar(uint32_t limite_ms);
+
+// Publicações na fila de saída (pendentes + em voo)
+uint32_t rede_host_profundidade(void);
+
+void rede_host_estatisticas(EstatisticasMqttHost *est);
+
+// Desfecho de uma medição dos benchmarks: só a falta de broker vira teste pulado
+typedef enum {
+    MEDICAO_OK = 0,
+    MEDICAO_SEM_BROKER,        // Conexão recusada: código 77 (pulado no CTest)
+    MEDICAO_SEM_CONFIRMACOES,  // A fila não esvaziou no prazo: falha
+} ResultadoMedicao;
+
+#define CODIGO_SEM_BROKER 77
+
+// Host e porta do broker: argumentos da linha de comando ou 127.0.0.1:1883
+void rede_host_broker(int argc, char **argv, const char **host, uint16_t *porta);
+
+#endif
@@ -0,0 +1,21 @@
+/**
+ * @file sync.h
+ * @brief Barreiras e seções críticas do host.
+ *
+ * `__dmb()` vira uma barreira completa do compilador e do processador, o que mantém
+ * a ordem de publicação da fila SPSC entre threads. Não há interrupções no host.
+ */
+
+#ifndef SDK_HOST_HARDWARE_SYNC_H
+#define SDK_HOST_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __sev(void) {}
+static inline void __wfe(void) {}
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t estado) { (void)estado; }
+
+#endif
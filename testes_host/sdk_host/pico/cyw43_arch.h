@@ -0,0 +1,4 @@
+// Vazio no host: `configura_geral.h` inclui este cabeçalho, mas os módulos testados não o usam
+#ifndef SDK_HOST_PICO_CYW43_ARCH_H
+#define SDK_HOST_PICO_CYW43_ARCH_H
+#endif
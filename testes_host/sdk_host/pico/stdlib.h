@@ -0,0 +1,29 @@
+/**
+ * @file stdlib.h
+ * @brief Substituto mínimo de `pico/stdlib.h` para compilar os módulos no host.
+ *
+ * Só declara o que os módulos testados usam; o relógio é o de `sdk_host.c`.
+ */
+
+#ifndef SDK_HOST_PICO_STDLIB_H
+#define SDK_HOST_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include "pico/time.h"
+#include "hardware/sync.h"
+
+typedef unsigned int uint;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define MIN(a, b) ((b) > (a) ? (a) : (b))
+#endif
+
+static inline void tight_loop_contents(void) {}
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file time.h
+ * @brief Relógio e alarmes do host (`sdk_host.c`).
+ *
+ * O relógio é o monotônico do sistema mais um deslocamento que os testes avançam com
+ * `sdk_host_avancar_us()`. Não há interrupções: os alarmes vencidos disparam quando o
+ * laço do teste chama `sdk_host_processar_alarmes()`.
+ */
+
+#ifndef SDK_HOST_PICO_TIME_H
+#define SDK_HOST_PICO_TIME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint64_t absolute_time_t;
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+typedef struct alarm_pool alarm_pool_t;
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+absolute_time_t make_timeout_time_us(uint64_t us);
+absolute_time_t make_timeout_time_ms(uint32_t ms);
+int64_t absolute_time_diff_us(absolute_time_t de, absolute_time_t ate);
+bool time_reached(absolute_time_t t);
+
+alarm_id_t add_alarm_at(absolute_time_t t, alarm_callback_t cb, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t cb, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t cb, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t id);
+
+// Só no host: adianta o relógio (prazos e intervalos nos testes)
+void sdk_host_avancar_us(uint64_t us);
+
+// Só no host: executa os callbacks dos alarmes vencidos
+void sdk_host_processar_alarmes(void);
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file sdk_host.c
+ * @brief Relógio e alarmes do host para os testes (`pico/time.h`).
+ */
+
+#include "pico/time.h"
+#include <stddef.h>
+#include <time.h>
+
+#define SDK_HOST_MAX_ALARMES 16
+
+typedef struct {
+    alarm_id_t id;                // 0 = posição livre
+    absolute_time_t instante;
+    alarm_callback_t cb;
+    void *user_data;
+} AlarmeHost;
+
+static uint64_t deslocamento_us = 0;
+static alarm_id_t proximo_alarme = 1;
+static AlarmeHost alarmes[SDK_HOST_MAX_ALARMES];
+
+uint64_t time_us_64(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u + deslocamento_us;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+absolute_time_t get_absolute_time(void) {
+    return time_us_64();
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us) {
+    return time_us_64() + us;
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return time_us_64() + (uint64_t)ms * 1000u;
+}
+
+int64_t absolute_time_diff_us(absolute_time_t de, absolute_time_t ate) {
+    return (int64_t)(ate - de);
+}
+
+bool time_reached(absolute_time_t t) {
+    return time_us_64() >= t;
+}
+
+alarm_id_t add_alarm_at(absolute_time_t t, alarm_callback_t cb, void *user_data, bool fire_if_past) {
+    for (int i = 0; i < SDK_HOST_MAX_ALARMES; i++) {
+        if (alarmes[i].id == 0) {
+            alarmes[i] = (AlarmeHost){proximo_alarme++, t, cb, user_data};
+            return alarmes[i].id;
+        }
+    }
+    return -1;   // Como o SDK sem posição livre no pool
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t cb, void *user_data, bool fire_if_past) {
+    return add_alarm_at(make_timeout_time_us(us), cb, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t cb, void *user_data, bool fire_if_past) {
+    return add_alarm_at(make_timeout_time_ms(ms), cb, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t id) {
+    for (int i = 0; i < SDK_HOST_MAX_ALARMES; i++) {
+        if (alarmes[i].id == id && id != 0) {
+            alarmes[i].id = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+void sdk_host_processar_alarmes(void) {
+    for (int i = 0; i < SDK_HOST_MAX_ALARMES; i++) {
+        AlarmeHost a = alarmes[i];
+        if (a.id == 0 || !time_reached(a.instante)) {
+            continue;
+        }
+        // Libera antes do callback, que pode armar outro alarme nesta posição
+        alarmes[i].id = 0;
+        int64_t repetir = a.cb(a.id, a.user_data);
+        if (repetir > 0 && alarmes[i].id == 0) {
+            alarmes[i] = (AlarmeHost){a.id, make_timeout_time_us((uint64_t)repetir), a.cb, a.user_data};
+        }
+    }
+}
+
+void sdk_host_avancar_us(uint64_t us) {
+    deslocamento_us += us;
+}
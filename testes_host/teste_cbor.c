@@ -0,0 +1,173 @@
+/**
+ * @file teste_cbor.c
+ * @brief Testes do codificador e do decodificador CBOR (`cbor_mini.c`).
+ *
+ * Além da ida e volta dos tipos usados pelo firmware, o decodificador recebe entradas
+ * truncadas em cada posição e comprimentos maiores que o buffer (inclusive perto de
+ * 2^64, que davam a volta em `pos + arg`). Compilado com AddressSanitizer: qualquer
+ * leitura fora do buffer derruba o teste.
+ */
+
+#include "cbor_mini.h"
+#include "verificar.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Cópia em um bloco do tamanho exato, para o sanitizador pegar leituras além do fim
+static bool ler_isolado(const uint8_t *dados, size_t tam, CborItem *item, size_t *consumidos) {
+    uint8_t *copia = malloc(tam ? tam : 1);
+    memcpy(copia, dados, tam);
+    CborLeitor r;
+    cbor_leitor_iniciar(&r, copia, tam);
+    bool ok = cbor_ler(&r, item);
+    if (consumidos) {
+        *consumidos = r.pos;
+    }
+    free(copia);
+    return ok;
+}
+
+static void ida_e_volta(void) {
+    uint8_t buf[64];
+    CborEscritor w;
+    cbor_iniciar(&w, buf, sizeof(buf));
+    cbor_mapa(&w, 6);
+    cbor_u32(&w, TEL_RSSI);
+    cbor_i32(&w, -52);
+    cbor_u32(&w, TEL_INSTANTE_US);
+    cbor_u64(&w, 0x123456789ull);
+    cbor_u32(&w, TEL_ONLINE);
+    cbor_bool(&w, true);
+    cbor_u32(&w, TEL_SEQ);
+    cbor_i32(&w, INT32_MIN);
+    cbor_u32(&w, TEL_RTT_P50_US);
+    cbor_float(&w, 12.5f);
+    cbor_u32(&w, TEL_STATUS_WIFI);
+    cbor_texto(&w, "conectado");
+    VERIFICAR(cbor_ok(&w));
+
+    CborLeitor r;
+    CborItem item;
+    int64_t v;
+    cbor_leitor_iniciar(&r, buf, cbor_tamanho(&w));
+    VERIFICAR(cbor_ler(&r, &item) && item.tipo == CBOR_MAPA && item.u == 6);
+    VERIFICAR(cbor_ler_inteiro(&r, &v) && v == TEL_RSSI);
+    VERIFICAR(cbor_ler_inteiro(&r, &v) && v == -52);
+    VERIFICAR(cbor_ler_inteiro(&r, &v) && v == TEL_INSTANTE_US);
+    VERIFICAR(cbor_ler_inteiro(&r, &v) && v == 0x123456789ll);
+    VERIFICAR(cbor_ler_inteiro(&r, &v) && v == TEL_ONLINE);
+    VERIFICAR(cbor_ler(&r, &item) && item.tipo == CBOR_BOOL && item.b);
+    VERIFICAR(cbor_ler_inteiro(&r, &v) && v == TEL_SEQ);
+    VERIFICAR(cbor_ler_inteiro(&r, &v) && v == INT32_MIN);
+    VERIFICAR(cbor_ler_inteiro(&r, &v) && v == TEL_RTT_P50_US);
+    VERIFICAR(cbor_ler(&r, &item) && item.tipo == CBOR_FLOAT && item.f == 12.5f);
+    VERIFICAR(cbor_ler_inteiro(&r, &v) && v == TEL_STATUS_WIFI);
+    VERIFICAR(cbor_ler(&r, &item) && item.tipo == CBOR_TEXTO && item.texto.tam == 9 &&
+              memcmp(item.texto.ptr, "conectado", 9) == 0);
+    VERIFICAR(!cbor_ler(&r, &item) && r.pos == r.tam);
+
+    // Escritor sem espaço: marca o estouro em vez de escrever além
+    cbor_iniciar(&w, buf, 3);
+    cbor_texto(&w, "longo demais");
+    VERIFICAR(!cbor_ok(&w) && cbor_tamanho(&w) <= 3);
+}
+
+// Todo prefixo próprio de um item é rejeitado sem ler além do fim
+static void truncados(void) {
+    uint8_t buf[32];
+    CborEscritor w;
+    const char *const casos[] = {"u64", "texto", "float", "negativo"};
+
+    for (size_t c = 0; c < sizeof(casos) / sizeof(casos[0]); c++) {
+        cbor_iniciar(&w, buf, sizeof(buf));
+        switch (c) {
+            case 0: cbor_u64(&w, UINT64_MAX); break;
+            case 1: cbor_texto(&w, "pico/telemetria/temperatura"); break;
+            case 2: cbor_float(&w, 3.25f); break;
+            default: cbor_i32(&w, -100000); break;
+        }
+        size_t tam = cbor_tamanho(&w);
+        CborItem item;
+        for (size_t corte = 0; corte < tam; corte++) {
+            if (ler_isolado(buf, corte, &item, NULL)) {
+                printf("%s truncado em %zu aceito\n", casos[c], corte);
+                falhas++;
+            }
+        }
+        size_t consumidos;
+        VERIFICAR(ler_isolado(buf, tam, &item, &consumidos) && consumidos == tam);
+    }
+}
+
+// Comprimentos de texto maiores que o restante do buffer
+static void tamanhos_excessivos(void) {
+    CborItem item;
+
+    const uint8_t texto_5_em_3[] = {0x65, 'a', 'b', 'c'};
+    VERIFICAR(!ler_isolado(texto_5_em_3, sizeof(texto_5_em_3), &item, NULL));
+
+    const uint8_t texto_4g[] = {0x7A, 0xFF, 0xFF, 0xFF, 0xFF, 'x'};
+    VERIFICAR(!ler_isolado(texto_4g, sizeof(texto_4g), &item, NULL));
+
+    // 2^64 - 1 e 2^64 - 8: `pos + arg` daria a volta e passaria pela verificação antiga
+    const uint8_t texto_max[] = {0x7B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 'x'};
+    VERIFICAR(!ler_isolado(texto_max, sizeof(texto_max), &item, NULL));
+    const uint8_t texto_quase_max[] = {0x7B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF8, 'x'};
+    VERIFICAR(!ler_isolado(texto_quase_max, sizeof(texto_quase_max), &item, NULL));
+
+    // Texto que ocupa exatamente o restante é válido
+    const uint8_t texto_exato[] = {0x63, 'a', 'b', 'c'};
+    VERIFICAR(ler_isolado(texto_exato, sizeof(texto_exato), &item, NULL) && item.texto.tam == 3);
+
+    // Inteiros fora de int64_t
+    const uint8_t negativo_max[] = {0x3B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    VERIFICAR(!ler_isolado(negativo_max, sizeof(negativo_max), &item, NULL));
+    const uint8_t negativo_min[] = {0x3B, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    VERIFICAR(ler_isolado(negativo_min, sizeof(negativo_min), &item, NULL) && item.i == INT64_MIN);
+
+    CborLeitor r;
+    int64_t v;
+    const uint8_t positivo_max[] = {0x1B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    cbor_leitor_iniciar(&r, positivo_max, sizeof(positivo_max));
+    VERIFICAR(!cbor_ler_inteiro(&r, &v));
+
+    // Comprimento indefinido e tipos simples desconhecidos
+    const uint8_t indefinido[] = {0x7F, 'a', 0xFF};
+    VERIFICAR(!ler_isolado(indefinido, sizeof(indefinido), &item, NULL));
+    const uint8_t simples[] = {0xF7};
+    VERIFICAR(!ler_isolado(simples, sizeof(simples), &item, NULL));
+}
+
+// Bytes arbitrários: o decodificador pode recusar, mas nunca sair do buffer
+static void aleatorios(void) {
+    uint32_t estado = 12345;
+    uint8_t buf[16];
+    for (int rodada = 0; rodada < 200000; rodada++) {
+        size_t tam = rodada % sizeof(buf) + 1;
+        for (size_t i = 0; i < tam; i++) {
+            estado = estado * 1103515245u + 12345u;
+            buf[i] = (uint8_t)(estado >> 16);
+        }
+        uint8_t *copia = malloc(tam);
+        memcpy(copia, buf, tam);
+        CborLeitor r;
+        CborItem item;
+        cbor_leitor_iniciar(&r, copia, tam);
+        while (cbor_ler(&r, &item)) {
+        }
+        if (r.pos > r.tam) {
+            falhas++;
+        }
+        free(copia);
+    }
+}
+
+int main(void) {
+    ida_e_volta();
+    truncados();
+    tamanhos_excessivos();
+    aleatorios();
+    printf("cbor: %d falhas\n", falhas);
+    return falhas ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file teste_fila_circular.c
+ * @brief Teste de estresse da fila SPSC com produtor e consumidor em threads distintas.
+ *
+ * O produtor insere uma sequência crescente, alternando inserções avulsas e em lote;
+ * o consumidor alterna remoções avulsas, em lote e espiadas. Cada elemento carrega a
+ * sequência em três formas: um elemento lido antes de ser publicado por inteiro, ou
+ * fora de ordem, é detectado pela verificação.
+ */
+
+#include "fila_circular.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TOTAL_ELEMENTOS 2000000u
+#define MAX_LOTE 5
+
+typedef struct {
+    uint32_t seq;
+    uint32_t complemento;   // ~seq
+    uint32_t hash;          // seq * constante de Knuth
+} Elemento;
+
+static Elemento preencher(uint32_t seq) {
+    Elemento e = {seq, ~seq, seq * 2654435761u};
+    return e;
+}
+
+static bool integro(const Elemento *e, uint32_t esperado) {
+    return e->seq == esperado && e->complemento == ~esperado && e->hash == esperado * 2654435761u;
+}
+
+typedef struct {
+    FilaCircular fila;
+    uint32_t falhas;
+} Contexto;
+
+static void *produtor(void *arg) {
+    Contexto *c = arg;
+    Elemento lote[MAX_LOTE];
+    uint32_t seq = 0;
+
+    while (seq < TOTAL_ELEMENTOS) {
+        uint32_t n = 1 + seq % MAX_LOTE;
+        if (n > TOTAL_ELEMENTOS - seq) {
+            n = TOTAL_ELEMENTOS - seq;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            lote[i] = preencher(seq + i);
+        }
+        uint32_t inseridos = n == 1 ? fila_inserir(&c->fila, &lote[0]) : fila_inserir_lote(&c->fila, lote, n);
+        if (inseridos == 0) {
+            sched_yield();
+        }
+        seq += inseridos;
+    }
+    return NULL;
+}
+
+static void *consumidor(void *arg) {
+    Contexto *c = arg;
+    Elemento lote[MAX_LOTE];
+    uint32_t esperado = 0;
+    uint32_t rodada = 0;
+
+    while (esperado < TOTAL_ELEMENTOS) {
+        uint32_t n;
+        switch (rodada++ % 3) {
+            case 0:
+                n = fila_remover(&c->fila, &lote[0]);
+                break;
+            case 1:
+                n = fila_remover_lote(&c->fila, lote, MAX_LOTE);
+                break;
+            default:
+                // Espiar não consome: o mesmo elemento deve sair na remoção seguinte
+                if (fila_espiar(&c->fila, &lote[0]) && !integro(&lote[0], esperado)) {
+                    c->falhas++;
+                }
+                n = fila_remover(&c->fila, &lote[0]);
+                break;
+        }
+        if (n == 0) {
+            sched_yield();
+        }
+        for (uint32_t i = 0; i < n; i++, esperado++) {
+            if (!integro(&lote[i], esperado)) {
+                if (c->falhas++ < 10) {
+                    fprintf(stderr, "esperado %u, lido %u/%08x/%08x\n",
+                            esperado, lote[i].seq, lote[i].complemento, lote[i].hash);
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+static int estressar(uint32_t capacidade) {
+    static Elemento buffer[TAM_FILA];
+    Contexto c = {.falhas = 0};
+    pthread_t p, q;
+
+    fila_inicializar(&c.fila, buffer, sizeof(Elemento), capacidade);
+    pthread_create(&q, NULL, consumidor, &c);
+    pthread_create(&p, NULL, produtor, &c);
+    pthread_join(p, NULL);
+    pthread_join(q, NULL);
+
+    bool ok = c.falhas == 0 && fila_vazia(&c.fila);
+    printf("capacidade %2u: %u elementos, %u falhas%s\n", capacidade, TOTAL_ELEMENTOS, c.falhas,
+           ok ? "" : " (ERRO)");
+    return ok ? 0 : 1;
+}
+
+// Casos de borda em uma thread: lote maior que o espaço livre e volta do índice
+static int limites(void) {
+    static Elemento buffer[4];
+    Elemento lote[6];
+    FilaCircular f;
+    int erros = 0;
+
+    fila_inicializar(&f, buffer, sizeof(Elemento), 4);
+    for (uint32_t i = 0; i < 6; i++) {
+        lote[i] = preencher(i);
+    }
+    erros += fila_inserir_lote(&f, lote, 6) != 4;       // Só cabem 4
+    erros += fila_inserir(&f, &lote[4]);                 // Cheia
+    erros += fila_ocupacao(&f) != 4;
+    erros += fila_remover_lote(&f, lote, 3) != 3;
+    erros += !integro(&lote[2], 2);
+    erros += fila_inserir_lote(&f, lote, 3) != 3;        // Atravessa o fim do buffer
+    erros += fila_remover_lote(&f, lote, 6) != 4;
+    erros += !integro(&lote[0], 3) || !integro(&lote[1], 0) || !integro(&lote[3], 2);
+    erros += !fila_vazia(&f);
+
+    // Índices perto de 2^32: a ocupação continua certa após a volta
+    f.cabeca = f.cauda = UINT32_MAX - 1;
+    erros += fila_inserir_lote(&f, lote, 3) != 3;
+    erros += fila_ocupacao(&f) != 3;
+    erros += fila_remover_lote(&f, lote, 3) != 3;
+
+    printf("limites: %d erros\n", erros);
+    return erros != 0;
+}
+
+int main(void) {
+    int falhas = limites();
+    falhas += estressar(TAM_FILA);
+    falhas += estressar(2);
+    return falhas ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,284 @@
+/**
+ * @file teste_registro_flash.c
+ * @brief Testes do registro persistente (`registro_flash.c`) sobre um arquivo.
+ *
+ * O backend de arquivo (`backend_flash_arquivo.c`) tem a semântica da flash NOR, e
+ * reabri-lo simula um reboot. Os cenários cobrem a volta do anel sobrescrevendo o
+ * setor mais antigo, a retomada pela geração no boot, o reenvio passando da flash
+ * para o setor em RAM enquanto chegam mensagens novas, e entradas corrompidas.
+ */
+
+#include "registro_flash.h"
+#include "verificar.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TAM_TOPICO   7    // "r/00000"
+#define TAM_DADOS    240
+#define TAM_ENTRADA  (5 + TAM_TOPICO + TAM_DADOS)
+#define POR_SETOR    ((REGISTRO_FLASH_TAM_SETOR - 12) / TAM_ENTRADA)
+#define MAX_RECEBIDOS 1024
+
+// O alarme de ciclo do registro sinaliza o laço de eventos, que aqui é o próprio teste
+void eventos_sinalizar(uint32_t mascara) {
+}
+
+static uint32_t recebidos[MAX_RECEBIDOS];
+static uint32_t n_recebidos;
+static uint32_t chamadas;
+static uint32_t recusar_a_cada;   // Simula a fila de saída cheia
+static uint32_t limite_aceitos;   // Para de aceitar após N mensagens
+
+static void zerar_recebidos(void) {
+    n_recebidos = 0;
+    chamadas = 0;
+    recusar_a_cada = 0;
+    limite_aceitos = MAX_RECEBIDOS;
+}
+
+static bool enviar(const char *topico, const void *dados, uint16_t tamanho,
+                   uint8_t qos, uint8_t retain) {
+    chamadas++;
+    if ((recusar_a_cada && chamadas % recusar_a_cada == 0) || n_recebidos >= limite_aceitos) {
+        return false;
+    }
+
+    uint32_t n = (uint32_t)strtoul(topico + 2, NULL, 10);
+    uint32_t n_dados;
+    memcpy(&n_dados, dados, sizeof(n_dados));
+    VERIFICAR(tamanho == TAM_DADOS);
+    VERIFICAR(n_dados == n);
+    VERIFICAR(((const uint8_t *)dados)[TAM_DADOS - 1] == (uint8_t)n);
+    VERIFICAR(qos == n % 3 && retain == (n & 1));
+    recebidos[n_recebidos++] = n;
+    return true;
+}
+
+static void anexar(uint32_t n) {
+    char topico[16];
+    uint8_t dados[TAM_DADOS];
+
+    snprintf(topico, sizeof(topico), "r/%05u", (unsigned)n);
+    memset(dados, (uint8_t)n, sizeof(dados));
+    memcpy(dados, &n, sizeof(n));
+    VERIFICAR(registro_flash_anexar(topico, dados, sizeof(dados), n % 3, n & 1));
+}
+
+static void anexar_faixa(uint32_t primeiro, uint32_t ultimo) {
+    for (uint32_t n = primeiro; n <= ultimo; n++) {
+        anexar(n);
+    }
+}
+
+// Um ciclo de reenvio: adianta o relógio até o próximo intervalo e processa
+static void ciclo(void) {
+    sdk_host_avancar_us(REGISTRO_FLASH_INTERVALO_MS * 1000);
+    sdk_host_processar_alarmes();
+    registro_flash_processar(enviar);
+}
+
+static void reproduzir_tudo(void) {
+    for (int i = 0; i < 100000 && !registro_flash_vazio(); i++) {
+        ciclo();
+    }
+    VERIFICAR(registro_flash_vazio());
+}
+
+// Grava o setor em RAM como faria o laço offline após REGISTRO_FLASH_SINCRONIA_MS
+static void sincronizar(void) {
+    sdk_host_avancar_us((uint64_t)REGISTRO_FLASH_SINCRONIA_MS * 1000 + 1);
+    registro_flash_sincronizar_se_antigo();
+}
+
+static void verificar_faixa(uint32_t inicio, uint32_t primeiro, uint32_t ultimo) {
+    VERIFICAR(n_recebidos >= inicio + (ultimo - primeiro + 1));
+    for (uint32_t n = primeiro; n <= ultimo && inicio + n - primeiro < n_recebidos; n++) {
+        if (recebidos[inicio + n - primeiro] != n) {
+            printf("  posição %u: esperado %u, recebido %u\n", (unsigned)(inicio + n - primeiro),
+                   (unsigned)n, (unsigned)recebidos[inicio + n - primeiro]);
+            falhas++;
+            return;
+        }
+    }
+}
+
+static uint32_t ler_u32_backend(const BackendFlash *b, uint32_t deslocamento) {
+    uint8_t p[4];
+    b->ler(b->ctx, deslocamento, p, sizeof(p));
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void criar_arquivo(char *caminho) {
+    strcpy(caminho, "/tmp/registro_flashXXXXXX");
+    int fd = mkstemp(caminho);
+    VERIFICAR(fd >= 0);
+    close(fd);
+}
+
+static EstatisticasRegistro estatisticas(void) {
+    EstatisticasRegistro e;
+    registro_flash_estatisticas(&e);
+    return e;
+}
+
+/**
+ * Dois setores na flash e o resto em RAM; durante o reenvio chegam mensagens novas
+ * suficientes para encher o setor em RAM e forçar outra gravação. A ordem de
+ * publicação tem de ser mantida mesmo com a fila de saída recusando entregas.
+ */
+static void reproducao_intercalada(void) {
+    char caminho[32];
+    BackendFlash b;
+    criar_arquivo(caminho);
+    VERIFICAR(backend_flash_arquivo_abrir(&b, caminho, 4));
+    registro_flash_inicializar(&b);
+    zerar_recebidos();
+
+    uint32_t total = 2 * POR_SETOR + 4;
+    anexar_faixa(0, total - 1);
+    VERIFICAR(estatisticas().setores_gravados == 2);
+    VERIFICAR(estatisticas().setores_pendentes == 2);
+
+    recusar_a_cada = 3;
+    for (int i = 0; i < 1000 && n_recebidos < 10; i++) {
+        ciclo();
+    }
+    anexar_faixa(total, total + POR_SETOR + 3);
+    VERIFICAR(estatisticas().setores_gravados == 3);
+
+    reproduzir_tudo();
+    verificar_faixa(0, 0, total + POR_SETOR + 3);
+    VERIFICAR(n_recebidos == total + POR_SETOR + 4);
+    VERIFICAR(estatisticas().reproduzidos == n_recebidos);
+    VERIFICAR(estatisticas().setores_pendentes == 0);
+
+    backend_flash_arquivo_fechar(&b);
+    remove(caminho);
+}
+
+/**
+ * Sete setores gravados num anel de quatro: os três mais antigos são sobrescritos e
+ * o reenvio começa no primeiro setor que sobreviveu.
+ */
+static void anel_sobrescreve_mais_antigo(void) {
+    char caminho[32];
+    BackendFlash b;
+    criar_arquivo(caminho);
+    VERIFICAR(backend_flash_arquivo_abrir(&b, caminho, 4));
+    registro_flash_inicializar(&b);
+    zerar_recebidos();
+
+    uint32_t ultimo = 7 * POR_SETOR + 4;
+    anexar_faixa(0, ultimo);
+    EstatisticasRegistro e = estatisticas();
+    VERIFICAR(e.setores_gravados == 7);
+    VERIFICAR(e.setores_perdidos == 3);
+    VERIFICAR(e.setores_pendentes == 4);
+
+    reproduzir_tudo();
+    verificar_faixa(0, 3 * POR_SETOR, ultimo);
+    VERIFICAR(n_recebidos == ultimo - 3 * POR_SETOR + 1);
+
+    backend_flash_arquivo_fechar(&b);
+    remove(caminho);
+}
+
+/**
+ * Depois de o anel dar a volta, um setor é consumido e o dispositivo reinicia. No boot
+ * o registro retoma pelo setor pendente de menor geração e continua gravando logo após
+ * o de maior geração, que não é o de maior índice.
+ */
+static void recuperacao_no_boot(void) {
+    char caminho[32];
+    BackendFlash b;
+    criar_arquivo(caminho);
+    VERIFICAR(backend_flash_arquivo_abrir(&b, caminho, 4));
+    registro_flash_inicializar(&b);
+    zerar_recebidos();
+
+    // Gerações 1..6 nos setores 0,1,2,3,0,1; pendentes 3..6; a última mensagem fica em RAM
+    anexar_faixa(0, 6 * POR_SETOR);
+    VERIFICAR(estatisticas().setores_perdidos == 2);
+
+    // Consome o setor da geração 3 (setor físico 2)
+    limite_aceitos = POR_SETOR;
+    for (int i = 0; i < 1000 && estatisticas().setores_pendentes == 4; i++) {
+        ciclo();
+    }
+    VERIFICAR(estatisticas().setores_pendentes == 3);
+    verificar_faixa(0, 2 * POR_SETOR, 3 * POR_SETOR - 1);
+    VERIFICAR(ler_u32_backend(&b, 2 * REGISTRO_FLASH_TAM_SETOR + 8) == 0);
+
+    // Reboot: o setor em RAM se perde, a flash não
+    backend_flash_arquivo_fechar(&b);
+    VERIFICAR(backend_flash_arquivo_abrir(&b, caminho, 4));
+    registro_flash_inicializar(&b);
+    zerar_recebidos();
+    VERIFICAR(estatisticas().setores_pendentes == 3);
+
+    // A próxima gravação vai para o setor físico 2, com a geração 7
+    anexar(500);
+    sincronizar();
+    VERIFICAR(ler_u32_backend(&b, 2 * REGISTRO_FLASH_TAM_SETOR + 4) == 7);
+    VERIFICAR(estatisticas().setores_pendentes == 4);
+
+    reproduzir_tudo();
+    verificar_faixa(0, 3 * POR_SETOR, 6 * POR_SETOR - 1);
+    VERIFICAR(n_recebidos == 3 * POR_SETOR + 1);
+    VERIFICAR(n_recebidos && recebidos[n_recebidos - 1] == 500);
+
+    backend_flash_arquivo_fechar(&b);
+    remove(caminho);
+}
+
+// Altera bytes de uma entrada já gravada (gravação interrompida ou bit trocado)
+static void corromper(const BackendFlash *b, uint32_t setor, uint32_t entrada,
+                      uint32_t campo, const uint8_t *bytes, uint32_t tamanho) {
+    static uint8_t setor_lido[REGISTRO_FLASH_TAM_SETOR];
+    b->ler(b->ctx, setor * REGISTRO_FLASH_TAM_SETOR, setor_lido, sizeof(setor_lido));
+    memcpy(&setor_lido[12 + entrada * TAM_ENTRADA + campo], bytes, tamanho);
+    VERIFICAR(b->gravar_setor(b->ctx, setor, setor_lido));
+}
+
+/**
+ * Uma entrada com marcador inválido e outra com comprimento impossível encerram os
+ * respectivos setores: o reenvio segue no setor seguinte e depois na RAM.
+ */
+static void entrada_corrompida(void) {
+    char caminho[32];
+    BackendFlash b;
+    criar_arquivo(caminho);
+    VERIFICAR(backend_flash_arquivo_abrir(&b, caminho, 4));
+    registro_flash_inicializar(&b);
+    zerar_recebidos();
+
+    anexar_faixa(0, 2 * POR_SETOR);
+    VERIFICAR(estatisticas().setores_gravados == 2);
+
+    const uint8_t marcador[] = {0x00};
+    const uint8_t tamanho[] = {0xFF, 0xFF};
+    corromper(&b, 0, 5, 0, marcador, sizeof(marcador));
+    corromper(&b, 1, 3, 3, tamanho, sizeof(tamanho));
+
+    reproduzir_tudo();
+    verificar_faixa(0, 0, 4);
+    verificar_faixa(5, POR_SETOR, POR_SETOR + 2);
+    verificar_faixa(8, 2 * POR_SETOR, 2 * POR_SETOR);
+    VERIFICAR(n_recebidos == 9);
+    VERIFICAR(ler_u32_backend(&b, 8) == 0);
+    VERIFICAR(ler_u32_backend(&b, REGISTRO_FLASH_TAM_SETOR + 8) == 0);
+
+    backend_flash_arquivo_fechar(&b);
+    remove(caminho);
+}
+
+int main(void) {
+    reproducao_intercalada();
+    anel_sobrescreve_mais_antigo();
+    recuperacao_no_boot();
+    entrada_corrompida();
+    printf("registro_flash: %d falhas\n", falhas);
+    return falhas ? EXIT_FAILURE : EXIT_SUCCESS;
+}
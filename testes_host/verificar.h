@@ -0,0 +1,24 @@
+/**
+ * @file verificar.h
+ * @brief Verificação comum dos testes de host: conta a falha e segue o teste.
+ *
+ * Cada teste inclui este cabeçalho uma única vez e, ao final, retorna
+ * `falhas ? EXIT_FAILURE : EXIT_SUCCESS`.
+ */
+
+#ifndef VERIFICAR_H
+#define VERIFICAR_H
+
+#include <stdio.h>
+
+static int falhas = 0;
+
+#define VERIFICAR(cond)                                              \
+    do {                                                             \
+        if (!(cond)) {                                               \
+            printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+            falhas++;                                                \
+        }                                                            \
+    } while (0)
+
+#endif